@@ -9,8 +9,11 @@
 #include "blockdb_db.h"
 #include "core/core_workload.h"
 #include "core/db_factory.h"
+#include "core/scan_profile.h"
 #include "utils/utils.h"
 
+#include <sstream>
+
 
 namespace {
   const std::string PROP_NAME = "dbpath";
@@ -72,6 +75,7 @@ namespace {
 namespace ycsbc {
 
 leveldb::DB *BlockdbDB::db_ = nullptr;
+leveldb::Cache *BlockdbDB::block_cache_ = nullptr;
 int BlockdbDB::ref_cnt_ = 0;
 std::mutex BlockdbDB::mu_;
 
@@ -125,6 +129,7 @@ void BlockdbDB::Init() {
 
   leveldb::Options opt;
   GetOptions(props, &opt);
+  block_cache_ = opt.block_cache;
 
   // 打印设置的值
   std::cout << "Create if missing: " << (opt.create_if_missing ? "true" : "false") << std::endl;
@@ -377,8 +382,13 @@ DB::Status BlockdbDB::ReadSingleEntry(const std::string &table, const std::strin
 DB::Status BlockdbDB::ScanSingleEntry(const std::string &table, const std::string &key, int len,
                                       const std::vector<std::string> *fields,
                                       std::vector<std::vector<Field>> &result) {
+  ScanProfile::Timer timer;
+  timer.Start();
   leveldb::Iterator *db_iter = db_->NewIterator(leveldb::ReadOptions());
+  timer.Stop(ScanProfile::CREATE);
+  timer.Start();
   db_iter->Seek(key);
+  timer.Stop(ScanProfile::SEEK);
   for (int i = 0; db_iter->Valid() && i < len; i++) {
     std::string data = db_iter->value().ToString();
     result.push_back(std::vector<Field>());
@@ -388,7 +398,9 @@ DB::Status BlockdbDB::ScanSingleEntry(const std::string &table, const std::strin
     } else {
       DeserializeRow(&values, data);
     }
+    timer.Start();
     db_iter->Next();
+    timer.Stop(ScanProfile::NEXT);
   }
   delete db_iter;
   return kOK;
@@ -499,8 +511,14 @@ DB::Status BlockdbDB::ReadCompKeyRM(const std::string &table, const std::string
 DB::Status BlockdbDB::ScanCompKeyRM(const std::string &table, const std::string &key, int len,
                                     const std::vector<std::string> *fields,
                                     std::vector<std::vector<Field>> &result) {
+  // a record is fieldcount entries, every step to the next field is a NEXT
+  ScanProfile::Timer timer;
+  timer.Start();
   leveldb::Iterator *db_iter = db_->NewIterator(leveldb::ReadOptions());
+  timer.Stop(ScanProfile::CREATE);
+  timer.Start();
   db_iter->Seek(key);
+  timer.Stop(ScanProfile::SEEK);
   assert(db_iter->Valid() && KeyFromCompKey(db_iter->key().ToString()) == key);
   for (int i = 0; i < len && db_iter->Valid(); i++) {
     result.push_back(std::vector<Field>());
@@ -518,7 +536,9 @@ DB::Status BlockdbDB::ScanCompKeyRM(const std::string &table, const std::string
           values.push_back({cur_field, cur_val});
           filter_iter++;
         }
+        timer.Start();
         db_iter->Next();
+        timer.Stop(ScanProfile::NEXT);
       }
       assert(values.size() == fields->size());
     } else {
@@ -530,7 +550,9 @@ DB::Status BlockdbDB::ScanCompKeyRM(const std::string &table, const std::string
         assert(cur_field == field_prefix_ + std::to_string(j));
 
         values.push_back({cur_field, cur_val});
+        timer.Start();
         db_iter->Next();
+        timer.Stop(ScanProfile::NEXT);
       }
       assert(values.size() == fieldcount_);
     }
@@ -586,6 +608,49 @@ DB::Status BlockdbDB::DeleteCompKey(const std::string &table, const std::string
   return kOK;
 }
 
+DB::Status BlockdbDB::GetMetrics(std::map<std::string, double> *metrics) {
+  // the handle is shared with, and closed by, the client threads
+  const std::lock_guard<std::mutex> lock(mu_);
+  if (db_ == nullptr) {
+    return kError;
+  }
+  // BlockDB answers to the LevelDB property names; metrics are reported as blockdb.*
+  std::string value;
+  for (int level = 0; ; level++) {
+    std::string name = "num-files-at-level" + std::to_string(level);
+    if (!db_->GetProperty("leveldb." + name, &value)) {
+      break;
+    }
+    (*metrics)["blockdb." + name] = std::stod(value);
+  }
+  // level sizes and compaction traffic are only exposed in the stats table:
+  // "level files size(MB) time(sec) read(MB) write(MB)" per non-empty level
+  if (db_->GetProperty("leveldb.stats", &value)) {
+    std::istringstream stats(value);
+    std::string line;
+    while (std::getline(stats, line)) {
+      std::istringstream row(line);
+      int level;
+      double files, size_mb, time_sec, read_mb, write_mb;
+      if (row >> level >> files >> size_mb >> time_sec >> read_mb >> write_mb) {
+        std::string prefix = "blockdb.level" + std::to_string(level);
+        (*metrics)[prefix + ".size-mb"] = size_mb;
+        (*metrics)[prefix + ".compaction-sec"] = time_sec;
+        (*metrics)[prefix + ".compaction-read-mb"] = read_mb;
+        (*metrics)[prefix + ".compaction-write-mb"] = write_mb;
+      }
+    }
+  }
+  // memtables, immutable memtable and block cache
+  if (db_->GetProperty("leveldb.approximate-memory-usage", &value)) {
+    (*metrics)["blockdb.approximate-memory-usage"] = std::stod(value);
+  }
+  if (block_cache_ != nullptr) {
+    (*metrics)["blockdb.block-cache-usage"] = block_cache_->TotalCharge();
+  }
+  return kOK;
+}
+
 void BlockdbDB::PrintStats() { 
     std::string stats;
     if(nullptr == db_)
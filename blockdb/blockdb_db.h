@@ -9,6 +9,7 @@
 #define YCSB_C_BLOCKDB_DB_H_
 
 #include <iostream>
+#include <map>
 #include <string>
 #include <mutex>
 
@@ -41,6 +42,8 @@ class BlockdbDB : public DB {
 
   void PrintStats();
 
+  Status GetMetrics(std::map<std::string, double> *metrics);
+
   Status Read(const std::string &table, const std::string &key,
               const std::vector<std::string> *fields, std::vector<Field> &result) {
     return (this->*(method_read_))(table, key, fields, result);
@@ -121,6 +124,7 @@ class BlockdbDB : public DB {
   std::string field_prefix_;
 
   static leveldb::DB *db_;
+  static leveldb::Cache *block_cache_;
   static int ref_cnt_;
   static std::mutex mu_;
 };
@@ -0,0 +1,134 @@
+//
+//  amplification_monitor.cc
+//  YCSB-cpp
+//
+
+#include "amplification_monitor.h"
+#include "utils/utils.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+#include <sys/stat.h>
+
+namespace ycsbc {
+
+AmplificationMonitor::AmplificationMonitor(utils::Properties *props, const PayloadMonitor *payload,
+                                           bool load)
+    : dbpath_(props->GetProperty("dbpath", "")), payload_(payload), start_written_(0),
+      start_has_io_(false), start_write_bytes_(0) {
+  preloaded_records_ = load ? 0 : std::stoull(props->GetProperty(CoreWorkload::RECORD_COUNT_PROPERTY, "0"));
+  default_record_bytes_ = CoreWorkload::EstimatedRecordBytes(*props);
+  StartPhase();
+}
+
+bool AmplificationMonitor::ReadWriteBytes(uint64_t *write_bytes) {
+  std::ifstream io("/proc/self/io");
+  std::string key;
+  uint64_t value;
+  while (io >> key >> value) {
+    if (key == "write_bytes:") {
+      *write_bytes = value;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool AmplificationMonitor::ReadDbSize(uint64_t *bytes) const {
+  std::error_code ec;
+  if (dbpath_.empty() || !std::filesystem::exists(dbpath_, ec)) {
+    return false;
+  }
+  // allocated blocks, like du, so preallocated and sparse files count as stored
+  *bytes = 0;
+  struct stat st;
+  if (!std::filesystem::is_directory(dbpath_, ec)) {
+    if (stat(dbpath_.c_str(), &st) != 0) {
+      return false;
+    }
+    *bytes = st.st_blocks * 512;
+    return true;
+  }
+  for (auto it = std::filesystem::recursive_directory_iterator(dbpath_, ec);
+       !ec && it != std::filesystem::recursive_directory_iterator(); it.increment(ec)) {
+    if (it->is_regular_file(ec) && stat(it->path().c_str(), &st) == 0) {
+      *bytes += st.st_blocks * 512;
+    }
+  }
+  return !ec;
+}
+
+void AmplificationMonitor::Sum(uint64_t *written, uint64_t *inserts, uint64_t *insert_bytes) const {
+  PayloadMonitor::Counts totals[MAXOPTYPE];
+  payload_->Totals(totals);
+  *written = totals[INSERT].request_bytes + totals[UPDATE].request_bytes +
+             totals[READMODIFYWRITE].request_bytes;
+  *inserts = totals[INSERT].ops;
+  *insert_bytes = totals[INSERT].request_bytes;
+}
+
+void AmplificationMonitor::StartPhase() {
+  uint64_t inserts, insert_bytes;
+  Sum(&start_written_, &inserts, &insert_bytes);
+  start_has_io_ = ReadWriteBytes(&start_write_bytes_);
+}
+
+AmplificationMonitor::Report AmplificationMonitor::Take() {
+  Report r;
+  uint64_t written, inserts, insert_bytes;
+  Sum(&written, &inserts, &insert_bytes);
+  r.logical_bytes = written - start_written_;
+  uint64_t write_bytes = 0;
+  r.has_io = start_has_io_ && ReadWriteBytes(&write_bytes);
+  r.physical_bytes = r.has_io ? write_bytes - start_write_bytes_ : 0;
+  r.has_size = ReadDbSize(&r.db_bytes);
+  uint64_t record_bytes = inserts > 0 ? insert_bytes / inserts : default_record_bytes_;
+  r.live_bytes = (preloaded_records_ + inserts) * record_bytes;
+  return r;
+}
+
+void AmplificationMonitor::Print() {
+  Report r = Take();
+  if (r.logical_bytes == 0 && !r.has_size) {
+    return;
+  }
+  printf("********** amplification **********\n");
+  printf("logical writes: %.2f MB\n", r.logical_bytes / utils::kMB);
+  if (r.has_io) {
+    printf("physical writes: %.2f MB", r.physical_bytes / utils::kMB);
+    if (r.logical_bytes > 0) {
+      printf("  write amplification: %.2f", 1.0 * r.physical_bytes / r.logical_bytes);
+    }
+    printf("\n");
+  }
+  if (r.has_size) {
+    printf("db size: %.2f MB  live data (est.): %.2f MB", r.db_bytes / utils::kMB, r.live_bytes / utils::kMB);
+    if (r.live_bytes > 0) {
+      printf("  space amplification: %.2f", 1.0 * r.db_bytes / r.live_bytes);
+    }
+    printf("\n");
+  }
+  printf("***********************************\n");
+}
+
+void AmplificationMonitor::Export(ResultsExporter *exporter, const std::string &phase) {
+  Report r = Take();
+  exporter->AddMetric(phase, "amplification.logical_write_bytes", r.logical_bytes);
+  if (r.has_io) {
+    exporter->AddMetric(phase, "amplification.physical_write_bytes", r.physical_bytes);
+    if (r.logical_bytes > 0) {
+      exporter->AddMetric(phase, "amplification.write", 1.0 * r.physical_bytes / r.logical_bytes);
+    }
+  }
+  if (r.has_size) {
+    exporter->AddMetric(phase, "amplification.db_bytes", r.db_bytes);
+    exporter->AddMetric(phase, "amplification.live_bytes", r.live_bytes);
+    if (r.live_bytes > 0) {
+      exporter->AddMetric(phase, "amplification.space", 1.0 * r.db_bytes / r.live_bytes);
+    }
+  }
+}
+
+} // ycsbc
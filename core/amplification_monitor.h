@@ -0,0 +1,70 @@
+//
+//  amplification_monitor.h
+//  YCSB-cpp
+//
+
+#ifndef YCSB_C_AMPLIFICATION_MONITOR_H_
+#define YCSB_C_AMPLIFICATION_MONITOR_H_
+
+#include <cstdint>
+#include <string>
+
+#include "payload_monitor.h"
+#include "results_exporter.h"
+#include "utils/properties.h"
+
+namespace ycsbc {
+
+///
+/// Compares the logical bytes the client wrote (keys, field names and values
+/// of successful inserts, updates and read-modify-writes) with what the engine
+/// physically wrote (write_bytes of /proc/self/io) and stores (allocated
+/// size of the files under dbpath) as write and space amplification per phase.
+///
+/// The live logical data is estimated as the number of records times the
+/// mean logical size of an insert: recordcount records are assumed to be
+/// loaded already unless the load phase runs in this process. Deletes are
+/// not accounted.
+///
+class AmplificationMonitor {
+ public:
+  ///
+  /// The logical writes are the request bytes payload accounts.
+  ///
+  AmplificationMonitor(utils::Properties *props, const PayloadMonitor *payload, bool load);
+
+  ///
+  /// Takes the baseline of a phase.
+  ///
+  void StartPhase();
+
+  void Print();
+  void Export(ResultsExporter *exporter, const std::string &phase);
+
+ private:
+  struct Report {
+    uint64_t logical_bytes;  // written in the phase
+    bool has_io;
+    uint64_t physical_bytes; // written in the phase
+    bool has_size;
+    uint64_t db_bytes;
+    uint64_t live_bytes;     // estimated, 0 if unknown
+  };
+
+  Report Take();
+  void Sum(uint64_t *written, uint64_t *inserts, uint64_t *insert_bytes) const;
+  static bool ReadWriteBytes(uint64_t *write_bytes);
+  bool ReadDbSize(uint64_t *bytes) const;
+
+  std::string dbpath_;
+  uint64_t preloaded_records_;
+  uint64_t default_record_bytes_; // if no insert was seen
+  const PayloadMonitor *payload_;
+  uint64_t start_written_;
+  bool start_has_io_;
+  uint64_t start_write_bytes_;
+};
+
+} // ycsbc
+
+#endif // YCSB_C_AMPLIFICATION_MONITOR_H_
@@ -9,41 +9,86 @@
 #ifndef YCSB_C_CLIENT_H_
 #define YCSB_C_CLIENT_H_
 
+#include <atomic>
+#include <chrono>
 #include <iostream>
 #include <string>
+#include <thread>
 
 #include "db.h"
 #include "core_workload.h"
+#include "harness_profile.h"
+#include "thread_measurements.h"
 #include "utils/countdown_latch.h"
 #include "utils/rate_limit.h"
+#include "utils/timer.h"
 #include "utils/utils.h"
 
 namespace ycsbc {
 
-inline int ClientThread(ycsbc::DB *db, ycsbc::CoreWorkload *wl, const int num_ops, bool is_loading,
-                        bool init_db, bool cleanup_db, utils::CountDownLatch *latch, utils::RateLimiter *rlim) {
+// A background thread (stop set) issues transactions until *stop instead of
+// num_ops of them, pausing CoreWorkload::BackgroundInterval() between two.
+// An idle transaction (CoreWorkload::LastTransactionIdle()) is retried with a
+// backoff and counts neither against num_ops nor the rate limit; the thread
+// gives up on it once CoreWorkload::Exhausted().
+inline int ClientThread(ycsbc::DB *db, ycsbc::CoreWorkload *wl, const int thread_id, const int num_ops,
+                        bool is_loading, bool init_db, utils::CountDownLatch *latch,
+                        utils::RateLimiter *rlim, HarnessProfile *harness, double *runtime_sec,
+                        PerThreadMeasurements *measurements, const std::atomic<bool> *stop) {
 
   try {
     if (init_db) {
       db->Init();
     }
+    wl->InitThread(thread_id);
 
+    utils::Timer<double> timer;
+    timer.Start();
     int ops = 0;
-    for (int i = 0; i < num_ops; ++i) {
-      if (rlim) {
+    const std::chrono::milliseconds pause = stop ? wl->BackgroundInterval() : std::chrono::milliseconds(0);
+    const int idle_spins = 64;
+    const std::chrono::microseconds idle_sleep(100);
+    int idle = 0;
+    for (int i = 0; stop ? !stop->load(std::memory_order_relaxed) : i < num_ops; ++i) {
+      if (rlim && idle == 0) {
         rlim->Consume(1);
       }
 
+      if (harness) {
+        harness->Begin();
+      }
       if (is_loading) {
         wl->DoInsert(*db);
       } else {
         wl->DoTransaction(*db);
       }
+      if (harness) {
+        harness->End();
+      }
+      if (!is_loading && wl->LastTransactionIdle()) {
+        if (wl->Exhausted()) {
+          break;
+        }
+        if (++idle < idle_spins) {
+          std::this_thread::yield();
+        } else {
+          std::this_thread::sleep_for(idle_sleep);
+        }
+        --i;
+        continue;
+      }
+      idle = 0;
+      measurements->AddOperation(thread_id);
       ops++;
+      if (pause.count() > 0) {
+        std::this_thread::sleep_for(pause);
+      }
     }
-
-    if (cleanup_db) {
-      db->Cleanup();
+    if (!is_loading) {
+      wl->FinishThread(thread_id);
+    }
+    if (runtime_sec) {
+      *runtime_sec = timer.End();
     }
 
     latch->CountDown();
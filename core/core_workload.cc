@@ -13,21 +13,26 @@
 #include "skewed_latest_generator.h"
 #include "const_generator.h"
 #include "core_workload.h"
+#include "popularity_profile.h"
+#include "timeseries_workload.h"
+#include "queue_workload.h"
 #include "random_byte_generator.h"
 #include "utils/utils.h"
 #include "utils/timer.h"
 
+#include <cstdio>
 #include <iostream>
 #include <algorithm>
 #include <random>
 #include <string>
 #include <atomic>
+#include <chrono>
 
 using ycsbc::CoreWorkload;
 using namespace std;
 
 extern atomic<uint64_t> ops_cnt[ycsbc::Operation::READMODIFYWRITE + 1] ;    //操作个数
-extern atomic<uint64_t> ops_time[ycsbc::Operation::READMODIFYWRITE + 1] ;   //微秒
+extern atomic<uint64_t> ops_time[ycsbc::Operation::READMODIFYWRITE + 1] ;   //纳秒
 
 const char *ycsbc::kOperationString[ycsbc::MAXOPTYPE] = {
   "INSERT",
@@ -80,6 +85,21 @@ const string CoreWorkload::READMODIFYWRITE_PROPORTION_DEFAULT = "0.0";
 const string CoreWorkload::REQUEST_DISTRIBUTION_PROPERTY = "requestdistribution";
 const string CoreWorkload::REQUEST_DISTRIBUTION_DEFAULT = "uniform";
 
+const string CoreWorkload::SNAPSHOT_READERS_PROPERTY = "snapshot.readerthreads";
+const string CoreWorkload::SNAPSHOT_READERS_DEFAULT = "0";
+
+const string CoreWorkload::SNAPSHOT_HOLD_TIME_PROPERTY = "snapshot.holdtime_ms";
+const string CoreWorkload::SNAPSHOT_HOLD_TIME_DEFAULT = "60000";
+
+const string CoreWorkload::SNAPSHOT_SCAN_INTERVAL_PROPERTY = "snapshot.scaninterval_ms";
+const string CoreWorkload::SNAPSHOT_SCAN_INTERVAL_DEFAULT = "0";
+
+const string CoreWorkload::HOT_KEY_COUNT_PROPERTY = "hotkeycount";
+const string CoreWorkload::HOT_KEY_COUNT_DEFAULT = "0";
+
+const string CoreWorkload::KEY_PARTITIONING_PROPERTY = "keypartitioning";
+const string CoreWorkload::KEY_PARTITIONING_DEFAULT = "none";
+
 const string CoreWorkload::ZERO_PADDING_PROPERTY = "zeropadding";
 const string CoreWorkload::ZERO_PADDING_DEFAULT = "1";
 
@@ -109,8 +129,15 @@ const std::string CoreWorkload::ZIPFIAN_CONST_PROPERTY = "zipfian_const";
 const string CoreWorkload::KEY_LENGTH_PROPERTY = "key";
 const string CoreWorkload::KEY_LENGTH_DEFAULT = "1";
 
+const string CoreWorkload::WORKLOAD_PROPERTY = "workload";
+const string CoreWorkload::WORKLOAD_DEFAULT = "CoreWorkload";
+
 namespace ycsbc {
 
+thread_local int CoreWorkload::thread_id_ = 0;
+thread_local bool CoreWorkload::snapshot_held_ = false;
+thread_local std::chrono::steady_clock::time_point CoreWorkload::snapshot_start_;
+
 void CoreWorkload::Init(const utils::Properties &p) {
   table_name_ = p.GetProperty(TABLENAME_PROPERTY,TABLENAME_DEFAULT);
 
@@ -175,7 +202,14 @@ void CoreWorkload::Init(const utils::Properties &p) {
   // insert_key_sequence_ = new ConstGenerator(key);
   transaction_insert_key_sequence_ = new AcknowledgedCounterGenerator(record_count_);
 
-  if (request_dist == "uniform") {
+  hot_key_count_ = std::stoull(p.GetProperty(HOT_KEY_COUNT_PROPERTY, HOT_KEY_COUNT_DEFAULT));
+  if (hot_key_count_ > 0) {
+    if (hot_key_count_ > record_count_) {
+      throw utils::Exception("hotkeycount exceeds recordcount");
+    }
+    // all requests go to the first hot_key_count_ records, overriding requestdistribution
+    key_chooser_ = new UniformGenerator(0, hot_key_count_ - 1);
+  } else if (request_dist == "uniform") {
     key_chooser_ = new UniformGenerator(0, record_count_ - 1);
 
   } else if (request_dist == "zipfian") {
@@ -198,6 +232,57 @@ void CoreWorkload::Init(const utils::Properties &p) {
     throw utils::Exception("Unknown request distribution: " + request_dist);
   }
 
+  track_rank_ = utils::StrToBool(p.GetProperty(PopularityProfile::ENABLED_PROPERTY,
+                                               PopularityProfile::ENABLED_DEFAULT));
+  if (track_rank_ && (hot_key_count_ > 0 || request_dist != "zipfian")) {
+    throw utils::Exception(PopularityProfile::ENABLED_PROPERTY + " needs requestdistribution=zipfian");
+  }
+
+  std::string partitioning = p.GetProperty(KEY_PARTITIONING_PROPERTY, KEY_PARTITIONING_DEFAULT);
+  if (partitioning == "thread") {
+    if (hot_key_count_ > 0) {
+      throw utils::Exception("Key partitioning cannot be combined with hotkeycount");
+    }
+    if (request_dist == "latest") {
+      throw utils::Exception("Key partitioning is not supported for request distribution: " +
+                             request_dist);
+    }
+    // inserted keys would be shared by all threads and never requested
+    if (insert_proportion > 0) {
+      throw utils::Exception("Key partitioning cannot be combined with insertproportion");
+    }
+    // slices cover the loaded records only, so every thread always finds existing keys;
+    // the last slice also takes the remainder
+    int thread_count = std::stoi(p.GetProperty("threadcount", "1"));
+    uint64_t slice = record_count_ / thread_count;
+    if (slice == 0) {
+      throw utils::Exception("Key partitioning needs at least one record per thread");
+    }
+    for (int i = 0; i < thread_count; i++) {
+      uint64_t lo = i * slice;
+      uint64_t hi = (i == thread_count - 1) ? record_count_ - 1 : lo + slice - 1;
+      if (request_dist == "uniform") {
+        thread_key_choosers_.push_back(new UniformGenerator(lo, hi));
+      } else if (p.ContainsKey(ZIPFIAN_CONST_PROPERTY)) {
+        double zipfian_const = std::stod(p.GetProperty(ZIPFIAN_CONST_PROPERTY));
+        thread_key_choosers_.push_back(new ScrambledZipfianGenerator(lo, hi, zipfian_const));
+      } else {
+        thread_key_choosers_.push_back(new ScrambledZipfianGenerator(lo, hi));
+      }
+    }
+  } else if (partitioning != "none") {
+    throw utils::Exception("Unknown key partitioning: " + partitioning);
+  }
+
+  snapshot_readers_ = std::stoi(p.GetProperty(SNAPSHOT_READERS_PROPERTY, SNAPSHOT_READERS_DEFAULT));
+  if (snapshot_readers_ > 0 && snapshot_readers_ >= std::stoi(p.GetProperty("threadcount", "1"))) {
+    throw utils::Exception(SNAPSHOT_READERS_PROPERTY + " leaves no writer thread");
+  }
+  snapshot_hold_ms_ = std::stoi(p.GetProperty(SNAPSHOT_HOLD_TIME_PROPERTY, SNAPSHOT_HOLD_TIME_DEFAULT));
+  snapshot_scan_interval_ms_ = std::stoi(p.GetProperty(SNAPSHOT_SCAN_INTERVAL_PROPERTY,
+                                                       SNAPSHOT_SCAN_INTERVAL_DEFAULT));
+  db_path_ = p.GetProperty("dbpath", "");
+
   field_chooser_ = new UniformGenerator(0, field_count_ - 1);
 
   if (scan_len_dist == "uniform") {
@@ -225,6 +310,21 @@ ycsbc::Generator<uint64_t> *CoreWorkload::GetFieldLenGenerator(
   }
 }
 
+uint64_t CoreWorkload::EstimatedRecordBytes(const utils::Properties &p) {
+  // "user" and a hashed number, unless zeropadding is wider
+  uint64_t key_bytes = std::max(23, 4 + std::stoi(p.GetProperty(ZERO_PADDING_PROPERTY, ZERO_PADDING_DEFAULT)));
+  uint64_t field_count = std::stoull(p.GetProperty(FIELD_COUNT_PROPERTY, FIELD_COUNT_DEFAULT));
+  uint64_t field_length = std::stoull(p.GetProperty(FIELD_LENGTH_PROPERTY, FIELD_LENGTH_DEFAULT));
+  uint64_t name_bytes = p.GetProperty(FIELD_NAME_PREFIX, FIELD_NAME_PREFIX_DEFAULT).size() +
+                        std::to_string(field_count > 0 ? field_count - 1 : 0).size();
+  return key_bytes + field_count * (name_bytes + field_length);
+}
+
+void CoreWorkload::InitThread(int thread_id) {
+  thread_id_ = thread_id;
+  snapshot_held_ = false;
+}
+
 std::string CoreWorkload::BuildKeyName(uint64_t key_num) {
   if (!ordered_inserts_) {
     key_num = utils::Hash(key_num);
@@ -258,13 +358,33 @@ void CoreWorkload::BuildSingleValue(std::vector<ycsbc::DB::Field> &values) {
 }
 
 uint64_t CoreWorkload::NextTransactionKeyNum() {
+  Generator<uint64_t> *chooser = thread_key_choosers_.empty() ? key_chooser_ :
+                                                               thread_key_choosers_[thread_id_];
   uint64_t key_num;
+  if (track_rank_) {
+    uint64_t rank;
+    do {
+      key_num = static_cast<ScrambledZipfianGenerator *>(chooser)->Next(&rank);
+    } while (key_num > transaction_insert_key_sequence_->Last());
+    PopularityProfile::SetRank(rank);
+    return key_num;
+  }
   do {
-    key_num = key_chooser_->Next();
+    key_num = chooser->Next();
   } while (key_num > transaction_insert_key_sequence_->Last());
   return key_num;
 }
 
+bool CoreWorkload::NextAccessKeyNum(uint64_t *key_num) {
+  if (op_chooser_.Next() == INSERT) {
+    *key_num = transaction_insert_key_sequence_->Next();
+    transaction_insert_key_sequence_->Acknowledge(*key_num);
+  } else {
+    *key_num = NextTransactionKeyNum();
+  }
+  return true;
+}
+
 std::string CoreWorkload::NextFieldName() {
   return std::string(field_prefix_).append(std::to_string(field_chooser_->Next()));
 }
@@ -283,8 +403,11 @@ bool CoreWorkload::DoInsert(DB &db) {
 }
 
 bool CoreWorkload::DoTransaction(DB &db) {
+  if (thread_id_ < snapshot_readers_) {
+    return DoSnapshotRead(db);
+  }
   DB::Status status;
-  ycsbc::utils::Timer<uint64_t, std::micro> timer;
+  ycsbc::utils::NanoTimer timer;
   timer.Start();
   switch (op_chooser_.Next()) {
     case READ:
@@ -318,6 +441,53 @@ bool CoreWorkload::DoTransaction(DB &db) {
   return (status == DB::kOK);
 }
 
+bool CoreWorkload::DoSnapshotRead(DB &db) {
+  if (!snapshot_held_) {
+    if (db.StartSnapshot() == DB::kNotImplemented) {
+      throw utils::Exception("Snapshot readers are not supported by this db");
+    }
+    snapshot_held_ = true;
+    snapshot_start_ = std::chrono::steady_clock::now();
+    snapshots_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // kept apart from the writers' operation counts and times
+  utils::NanoTimer timer;
+  timer.Start();
+  DB::Status status = TransactionScan(db);
+  uint64_t latency = timer.End();
+  snapshot_scans_.fetch_add(1, std::memory_order_relaxed);
+  snapshot_scan_ns_.fetch_add(latency, std::memory_order_relaxed);
+  uint64_t max = snapshot_scan_max_ns_.load(std::memory_order_relaxed);
+  while (latency > max && !snapshot_scan_max_ns_.compare_exchange_weak(max, latency)) {
+  }
+
+  if (std::chrono::steady_clock::now() - snapshot_start_ >= std::chrono::milliseconds(snapshot_hold_ms_)) {
+    db.ReleaseSnapshot();
+    snapshot_held_ = false;
+  }
+  return (status == DB::kOK);
+}
+
+void CoreWorkload::PrintStats() {
+  if (snapshot_readers_ == 0) {
+    return;
+  }
+  // writer throughput is the run result above, which leaves the readers out
+  uint64_t scans = snapshot_scans_.load();
+  printf("********** snapshot readers **********\n");
+  printf("readers: %d  snapshots taken: %lu  scans: %lu\n", snapshot_readers_,
+         snapshots_.load(), scans);
+  if (scans > 0) {
+    printf("scan latency: avg %.2f us  max %.2f us\n", snapshot_scan_ns_.load() / 1000.0 / scans,
+           snapshot_scan_max_ns_.load() / 1000.0);
+  }
+  if (!db_path_.empty()) {
+    printf("db size: %.2f MB\n", utils::DirectorySize(db_path_) / 1048576.0);
+  }
+  printf("**************************************\n");
+}
+
 DB::Status CoreWorkload::TransactionRead(DB &db) {
   uint64_t key_num = NextTransactionKeyNum();
   const std::string key = BuildKeyName(key_num);
@@ -336,21 +506,40 @@ DB::Status CoreWorkload::TransactionReadModifyWrite(DB &db) {
   const std::string key = BuildKeyName(key_num);
   std::vector<DB::Field> result;
 
-  if (!read_all_fields()) {
-    std::vector<std::string> fields;
-    fields.push_back(NextFieldName());
-    db.Read(table_name_, key, &fields, result);
-  } else {
-    db.Read(table_name_, key, NULL, result);
+  if (hot_key_count_ == 0) {
+    // a separate read and update, reported as READ and UPDATE
+    if (!read_all_fields()) {
+      std::vector<std::string> fields;
+      fields.push_back(NextFieldName());
+      db.Read(table_name_, key, &fields, result);
+    } else {
+      db.Read(table_name_, key, NULL, result);
+    }
+
+    std::vector<DB::Field> values;
+    if (write_all_fields()) {
+      BuildValues(values);
+    } else {
+      BuildSingleValue(values);
+    }
+    return db.Update(table_name_, key, values);
   }
 
+  // contention mode: one READMODIFYWRITE, atomic where the engine supports it
   std::vector<DB::Field> values;
   if (write_all_fields()) {
     BuildValues(values);
   } else {
     BuildSingleValue(values);
   }
-  return db.Update(table_name_, key, values);
+
+  if (!read_all_fields()) {
+    std::vector<std::string> fields;
+    fields.push_back(NextFieldName());
+    return db.ReadModifyWrite(table_name_, key, &fields, result, values);
+  } else {
+    return db.ReadModifyWrite(table_name_, key, NULL, result, values);
+  }
 }
 
 DB::Status CoreWorkload::TransactionScan(DB &db) {
@@ -389,4 +578,20 @@ DB::Status CoreWorkload::TransactionInsert(DB &db) {
   return s;
 }
 
+CoreWorkload *CreateWorkload(const utils::Properties &p) {
+  std::string name = p.GetProperty(CoreWorkload::WORKLOAD_PROPERTY, CoreWorkload::WORKLOAD_DEFAULT);
+  size_t pos = name.rfind('.');
+  if (pos != std::string::npos) {
+    name = name.substr(pos + 1);
+  }
+  if (name == "CoreWorkload") {
+    return new CoreWorkload;
+  } else if (name == "TimeSeriesWorkload") {
+    return new TimeSeriesWorkload;
+  } else if (name == "QueueWorkload") {
+    return new QueueWorkload;
+  }
+  return nullptr;
+}
+
 } // ycsbc
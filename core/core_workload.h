@@ -10,6 +10,8 @@
 #ifndef YCSB_C_CORE_WORKLOAD_H_
 #define YCSB_C_CORE_WORKLOAD_H_
 
+#include <atomic>
+#include <chrono>
 #include <vector>
 #include <string>
 #include "db.h"
@@ -120,6 +122,47 @@ class CoreWorkload {
   static const std::string REQUEST_DISTRIBUTION_PROPERTY;
   static const std::string REQUEST_DISTRIBUTION_DEFAULT;
 
+  ///
+  /// The name of the property for the number of hot keys.
+  /// If positive, all request keys are drawn uniformly from that many
+  /// records, e.g. to measure read-modify-write contention, and each
+  /// read-modify-write is one DB::ReadModifyWrite() reported as
+  /// READMODIFYWRITE instead of a READ and an UPDATE. 0 disables it.
+  ///
+  static const std::string HOT_KEY_COUNT_PROPERTY;
+  static const std::string HOT_KEY_COUNT_DEFAULT;
+
+  ///
+  /// The name of the property for the number of snapshot reader threads.
+  /// The first that many client threads hold a database snapshot and scan
+  /// it while the other threads run the configured operation mix. Readers
+  /// scan until the other threads are done and are not counted in the phase.
+  ///
+  static const std::string SNAPSHOT_READERS_PROPERTY;
+  static const std::string SNAPSHOT_READERS_DEFAULT;
+
+  ///
+  /// The name of the property for how long a reader keeps one snapshot (ms).
+  ///
+  static const std::string SNAPSHOT_HOLD_TIME_PROPERTY;
+  static const std::string SNAPSHOT_HOLD_TIME_DEFAULT;
+
+  ///
+  /// The name of the property for the pause between two reader scans (ms).
+  ///
+  static const std::string SNAPSHOT_SCAN_INTERVAL_PROPERTY;
+  static const std::string SNAPSHOT_SCAN_INTERVAL_DEFAULT;
+
+  ///
+  /// The name of the property for partitioning the request key space.
+  /// Options are "none" (all threads share the key space) and "thread"
+  /// (each client thread draws request keys from its own disjoint slice
+  /// of the loaded records, with the same distribution shape; the last
+  /// thread's slice takes the remainder, and inserts are not supported).
+  ///
+  static const std::string KEY_PARTITIONING_PROPERTY;
+  static const std::string KEY_PARTITIONING_DEFAULT;
+
   ///
   /// The default zero padding value. Matches integer sort order
   ///
@@ -172,15 +215,82 @@ class CoreWorkload {
   static const std::string KEY_LENGTH_PROPERTY;
   static const std::string KEY_LENGTH_DEFAULT;
 
+  ///
+  /// The name of the property for the workload class to run.
+  /// Options are "CoreWorkload", "TimeSeriesWorkload" and "QueueWorkload",
+  /// optionally with a package prefix (e.g. "com.yahoo.ycsb.workloads.CoreWorkload").
+  ///
+  static const std::string WORKLOAD_PROPERTY;
+  static const std::string WORKLOAD_DEFAULT;
+
   ///
   /// Initialize the scenario.
   /// Called once, in the main client thread, before any operations are started.
   ///
   virtual void Init(const utils::Properties &p);
 
+  ///
+  /// Initialize per-thread state.
+  /// Called once in every client thread, before it starts issuing operations.
+  ///
+  virtual void InitThread(int thread_id);
+
   virtual bool DoInsert(DB &db);
   virtual bool DoTransaction(DB &db);
 
+  ///
+  /// Whether the last DoTransaction() of the calling thread issued no
+  /// operation at all (e.g. on a full or empty queue); such attempts are not
+  /// counted as operations.
+  ///
+  virtual bool LastTransactionIdle() const { return false; }
+
+  ///
+  /// Whether an idle calling thread can never issue an operation again,
+  /// e.g. a consumer of an empty queue whose producers have all finished.
+  ///
+  virtual bool Exhausted() const { return false; }
+
+  ///
+  /// Called by a client thread once it issued its last transaction.
+  ///
+  virtual void FinishThread(int thread_id) { }
+
+  ///
+  /// Whether a client thread runs in the background of the transaction
+  /// phase, e.g. a snapshot reader: it issues transactions until all other
+  /// threads have finished theirs, and its operations are not counted in
+  /// the phase total.
+  ///
+  virtual bool IsBackgroundThread(int thread_id) const { return thread_id < snapshot_readers_; }
+
+  ///
+  /// The pause of a background thread between two transactions, taken
+  /// outside of the measured operation.
+  ///
+  virtual std::chrono::milliseconds BackgroundInterval() const {
+    return std::chrono::milliseconds(snapshot_scan_interval_ms_);
+  }
+
+  ///
+  /// Typical logical size of a record in bytes: the key and the names and
+  /// values of fieldcount fields of fieldlength bytes.
+  ///
+  static uint64_t EstimatedRecordBytes(const utils::Properties &p);
+
+  ///
+  /// Draws the key number the next transaction would use without issuing it,
+  /// to analyze the access stream offline. Inserts extend the key space as in
+  /// a run; a scan only yields its start key. Returns false if the workload
+  /// cannot tell.
+  ///
+  virtual bool NextAccessKeyNum(uint64_t *key_num);
+
+  ///
+  /// Prints workload specific statistics. Called after each phase.
+  ///
+  virtual void PrintStats();
+
   bool read_all_fields() const { return read_all_fields_; }
   bool write_all_fields() const { return write_all_fields_; }
 
@@ -188,12 +298,18 @@ class CoreWorkload {
       field_count_(0), read_all_fields_(false), write_all_fields_(false),
       field_len_generator_(nullptr), key_chooser_(nullptr), field_chooser_(nullptr),
       scan_len_chooser_(nullptr), insert_key_sequence_(nullptr),
-      transaction_insert_key_sequence_(nullptr), ordered_inserts_(true), record_count_(0) {
+      transaction_insert_key_sequence_(nullptr), ordered_inserts_(true), record_count_(0),
+      hot_key_count_(0), track_rank_(false), snapshot_readers_(0), snapshot_hold_ms_(0),
+      snapshot_scan_interval_ms_(0), snapshots_(0), snapshot_scans_(0), snapshot_scan_ns_(0),
+      snapshot_scan_max_ns_(0) {
   }
 
   virtual ~CoreWorkload() {
     delete field_len_generator_;
     delete key_chooser_;
+    for (auto chooser : thread_key_choosers_) {
+      delete chooser;
+    }
     delete field_chooser_;
     delete scan_len_chooser_;
     delete insert_key_sequence_;
@@ -202,18 +318,19 @@ class CoreWorkload {
 
  protected:
   static Generator<uint64_t> *GetFieldLenGenerator(const utils::Properties &p);
-  std::string BuildKeyName(uint64_t key_num);
+  virtual std::string BuildKeyName(uint64_t key_num);
   void BuildValues(std::vector<DB::Field> &values);
   void BuildSingleValue(std::vector<DB::Field> &update);
 
   uint64_t NextTransactionKeyNum();
   std::string NextFieldName();
 
-  DB::Status TransactionRead(DB &db);
-  DB::Status TransactionReadModifyWrite(DB &db);
-  DB::Status TransactionScan(DB &db);
-  DB::Status TransactionUpdate(DB &db);
-  DB::Status TransactionInsert(DB &db);
+  virtual DB::Status TransactionRead(DB &db);
+  virtual DB::Status TransactionReadModifyWrite(DB &db);
+  virtual DB::Status TransactionScan(DB &db);
+  virtual DB::Status TransactionUpdate(DB &db);
+  virtual DB::Status TransactionInsert(DB &db);
+  bool DoSnapshotRead(DB &db);
 
   std::string table_name_;
   int field_count_;
@@ -223,6 +340,7 @@ class CoreWorkload {
   Generator<uint64_t> *field_len_generator_;
   DiscreteGenerator<Operation> op_chooser_;
   Generator<uint64_t> *key_chooser_; // transaction key gen
+  std::vector<Generator<uint64_t> *> thread_key_choosers_; // per-thread key gen if partitioned
   Generator<uint64_t> *field_chooser_;
   Generator<uint64_t> *scan_len_chooser_;
   CounterGenerator *insert_key_sequence_; // load insert key gen
@@ -230,9 +348,30 @@ class CoreWorkload {
   AcknowledgedCounterGenerator *transaction_insert_key_sequence_; // transaction insert key gen
   bool ordered_inserts_;
   size_t record_count_;
+  uint64_t hot_key_count_;
   int zero_padding_;
+  bool track_rank_; // key choosers are ScrambledZipfianGenerators reporting the rank
+
+  int snapshot_readers_;
+  int snapshot_hold_ms_;
+  int snapshot_scan_interval_ms_;
+  std::string db_path_;
+  std::atomic<uint64_t> snapshots_;
+  std::atomic<uint64_t> snapshot_scans_;
+  std::atomic<uint64_t> snapshot_scan_ns_; // sum of the reader scan latencies
+  std::atomic<uint64_t> snapshot_scan_max_ns_;
+
+  static thread_local int thread_id_; // index of the calling client thread
+  static thread_local bool snapshot_held_;
+  static thread_local std::chrono::steady_clock::time_point snapshot_start_;
 };
 
+///
+/// Creates the workload named by the "workload" property.
+/// Returns nullptr if the name is unknown. Init() is not called.
+///
+CoreWorkload *CreateWorkload(const utils::Properties &p);
+
 } // ycsbc
 
 #endif // YCSB_C_CORE_WORKLOAD_H_
@@ -12,6 +12,7 @@
 #include "utils/properties.h"
 
 #include <iostream>
+#include <map>
 #include <vector>
 #include <string>
 
@@ -103,6 +104,60 @@ class DB {
   /// @return Zero on success, a non-zero error code on error.
   ///
   virtual Status Delete(const std::string &table, const std::string &key) = 0;
+  ///
+  /// Reads a record and writes the given field/value pairs back to it.
+  /// The default issues a Read followed by an Update, without atomicity.
+  /// Engines with a native atomic read-modify-write override it, e.g. a
+  /// transaction that locks the record on read and retries on conflict.
+  ///
+  /// @param table The name of the table.
+  /// @param key The key of the record.
+  /// @param fields The list of fields to read, or NULL for all of them.
+  /// @param result A vector of field/value pairs for the read part.
+  /// @param values A vector of field/value pairs to update in the record.
+  /// @return Zero on success, a non-zero error code on error.
+  ///
+  virtual Status ReadModifyWrite(const std::string &table, const std::string &key,
+                                 const std::vector<std::string> *fields, std::vector<Field> &result,
+                                 std::vector<Field> &values) {
+    Read(table, key, fields, result);
+    return Update(table, key, values);
+  }
+
+  ///
+  /// Pins a consistent snapshot of the database for this instance.
+  /// Until ReleaseSnapshot() is called, reads and scans issued through this
+  /// instance see the snapshot while other instances keep writing.
+  ///
+  /// @return Zero on success, kNotImplemented if the engine has no snapshots.
+  ///
+  virtual Status StartSnapshot() { return kNotImplemented; }
+  ///
+  /// Releases the snapshot taken by StartSnapshot(), if any.
+  ///
+  virtual Status ReleaseSnapshot() { return kNotImplemented; }
+
+  ///
+  /// Samples engine-internal statistics (LSM shape, compaction backlog,
+  /// memtable and cache usage, ...) into a map keyed by metric name.
+  /// Called from the status thread while other instances keep running
+  /// operations, so it must only touch state shared by all instances.
+  ///
+  /// @param metrics The map the samples are added to.
+  /// @return Zero on success, kNotImplemented if the engine has no statistics.
+  ///
+  virtual Status GetMetrics(std::map<std::string, double> *metrics) { return kNotImplemented; }
+
+  ///
+  /// Adds the engine's counters of the calling thread (e.g. internal keys and
+  /// tombstones skipped by its iterators) to metrics. The counters are
+  /// cumulative; callers take the difference around the operations of
+  /// interest.
+  ///
+  /// @param metrics The map the counters are added to.
+  /// @return Zero on success, kNotImplemented if the engine has none.
+  ///
+  virtual Status GetThreadMetrics(std::map<std::string, double> *metrics) { return kNotImplemented; }
 
   // virtual bool HaveBalancedDistribution() { return true; };
 
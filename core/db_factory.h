@@ -10,7 +10,14 @@
 #define YCSB_C_DB_FACTORY_H_
 
 #include "db.h"
+#include "harness_profile.h"
+#include "latency_sampler.h"
 #include "measurements.h"
+#include "payload_monitor.h"
+#include "perf_counters.h"
+#include "popularity_profile.h"
+#include "slow_op_log.h"
+#include "working_set.h"
 #include "utils/properties.h"
 
 #include <string>
@@ -22,7 +29,13 @@ class DBFactory {
  public:
   using DBCreator = DB *(*)();
   static bool RegisterDB(std::string db_name, DBCreator db_creator);
-  static DB *CreateDB(utils::Properties *props, Measurements *measurements);
+  static DB *CreateDB(utils::Properties *props, Measurements *measurements,
+                      HarnessProfile *harness = nullptr, PerfCounters::Thread *perf = nullptr,
+                      SlowOpLog::Thread *slow_ops = nullptr,
+                      PayloadMonitor::Thread *payload = nullptr,
+                      PopularityProfile *popularity = nullptr,
+                      WorkingSet::Thread *working_set = nullptr,
+                      LatencySampler::Thread *samples = nullptr);
  private:
   static std::map<std::string, DBCreator> &Registry();
 };
@@ -8,11 +8,20 @@
 #ifndef YCSB_C_DB_WRAPPER_H_
 #define YCSB_C_DB_WRAPPER_H_
 
+#include <map>
 #include <string>
 #include <vector>
 
 #include "db.h"
+#include "harness_profile.h"
+#include "latency_sampler.h"
 #include "measurements.h"
+#include "payload_monitor.h"
+#include "perf_counters.h"
+#include "popularity_profile.h"
+#include "slow_op_log.h"
+#include "usdt.h"
+#include "working_set.h"
 #include "utils/timer.h"
 #include "utils/utils.h"
 
@@ -20,7 +29,14 @@ namespace ycsbc {
 
 class DBWrapper : public DB {
  public:
-  DBWrapper(DB *db, Measurements *measurements) : DB(db->GetProps()), db_(db), measurements_(measurements) {}
+  DBWrapper(DB *db, Measurements *measurements, HarnessProfile *harness = nullptr,
+            PerfCounters::Thread *perf = nullptr, SlowOpLog::Thread *slow_ops = nullptr,
+            PayloadMonitor::Thread *payload = nullptr,
+            PopularityProfile *popularity = nullptr, WorkingSet::Thread *working_set = nullptr,
+            LatencySampler::Thread *samples = nullptr)
+      : DB(db->GetProps()), db_(db), measurements_(measurements), harness_(harness), perf_(perf),
+        slow_ops_(slow_ops), payload_(payload), popularity_(popularity), working_set_(working_set),
+        samples_(samples) {}
   ~DBWrapper() {
     delete db_;
   }
@@ -32,62 +48,86 @@ class DBWrapper : public DB {
   }
   Status Read(const std::string &table, const std::string &key,
               const std::vector<std::string> *fields, std::vector<Field> &result) {
-    timer_.Start();
+    Start(READ, key);
     Status s = db_->Read(table, key, fields, result);
-    uint64_t elapsed = timer_.End();
-    if (s == kOK) {
-      measurements_->Report(READ, elapsed);
-    } else {
-      measurements_->Report(READ_FAILED, elapsed);
+    Operation op = s == kOK ? READ : READ_FAILED;
+    uint64_t elapsed = EndEngine(op);
+    if (s == kOK && payload_) {
+      payload_->AddRead(READ, key, fields, result);
     }
+    Record(op, elapsed, key, fields ? fields->size() : 0);
     return s;
   }
   Status Scan(const std::string &table, const std::string &key, int record_count,
               const std::vector<std::string> *fields, std::vector<std::vector<Field>> &result) {
-    timer_.Start();
+    Start(SCAN, key);
     Status s = db_->Scan(table, key, record_count, fields, result);
-    uint64_t elapsed = timer_.End();
-    if (s == kOK) {
-      measurements_->Report(SCAN, elapsed);
-    } else {
-      measurements_->Report(SCAN_FAILED, elapsed);
+    Operation op = s == kOK ? SCAN : SCAN_FAILED;
+    uint64_t elapsed = EndEngine(op);
+    if (s == kOK && payload_) {
+      payload_->AddScan(SCAN, key, fields, result);
     }
+    Record(op, elapsed, key, fields ? fields->size() : 0, record_count);
     return s;
   }
   Status Update(const std::string &table, const std::string &key, std::vector<Field> &values) {
-    timer_.Start();
+    Start(UPDATE, key);
     Status s = db_->Update(table, key, values);
-    uint64_t elapsed = timer_.End();
-    if (s == kOK) {
-      measurements_->Report(UPDATE, elapsed);
-    } else {
-      measurements_->Report(UPDATE_FAILED, elapsed);
+    Operation op = s == kOK ? UPDATE : UPDATE_FAILED;
+    uint64_t elapsed = EndEngine(op);
+    if (s == kOK && payload_) {
+      payload_->AddWrite(UPDATE, key, values);
     }
+    Record(op, elapsed, key, values.size());
     return s;
   }
   Status Insert(const std::string &table, const std::string &key, std::vector<Field> &values) {
-    timer_.Start();
+    Start(INSERT, key);
     Status s = db_->Insert(table, key, values);
-    uint64_t elapsed = timer_.End();
-    if (s == kOK) {
-      measurements_->Report(INSERT, elapsed);
-    } else {
-      measurements_->Report(INSERT_FAILED, elapsed);
+    Operation op = s == kOK ? INSERT : INSERT_FAILED;
+    uint64_t elapsed = EndEngine(op);
+    if (s == kOK && payload_) {
+      payload_->AddWrite(INSERT, key, values);
     }
+    Record(op, elapsed, key, values.size());
+    return s;
+  }
+  Status ReadModifyWrite(const std::string &table, const std::string &key,
+                         const std::vector<std::string> *fields, std::vector<Field> &result,
+                         std::vector<Field> &values) {
+    Start(READMODIFYWRITE, key);
+    Status s = db_->ReadModifyWrite(table, key, fields, result, values);
+    Operation op = s == kOK ? READMODIFYWRITE : READMODIFYWRITE_FAILED;
+    uint64_t elapsed = EndEngine(op);
+    if (s == kOK && payload_) {
+      payload_->AddReadModifyWrite(READMODIFYWRITE, key, result, values);
+    }
+    Record(op, elapsed, key, values.size());
     return s;
   }
   Status Delete(const std::string &table, const std::string &key) {
-    timer_.Start();
+    Start(DELETE, key);
     Status s = db_->Delete(table, key);
-    uint64_t elapsed = timer_.End();
-    if (s == kOK) {
-      measurements_->Report(DELETE, elapsed);
-    } else {
-      measurements_->Report(DELETE_FAILED, elapsed);
-    }
+    Operation op = s == kOK ? DELETE : DELETE_FAILED;
+    uint64_t elapsed = EndEngine(op);
+    Record(op, elapsed, key, 0);
     return s;
   }
 
+  Status StartSnapshot() {
+    return db_->StartSnapshot();
+  }
+  Status ReleaseSnapshot() {
+    return db_->ReleaseSnapshot();
+  }
+
+  Status GetMetrics(std::map<std::string, double> *metrics) {
+    return db_->GetMetrics(metrics);
+  }
+  Status GetThreadMetrics(std::map<std::string, double> *metrics) {
+    return db_->GetThreadMetrics(metrics);
+  }
+
   void PrintStats() {
     db_->PrintStats();
   }
@@ -97,9 +137,64 @@ class DBWrapper : public DB {
   }
 
  private:
+  // The instrumentation before and after the engine call, up to the end of
+  // Record(), is reported to harness as recording, not as generation.
+  void Start(Operation op, const std::string &key) {
+    uint64_t begin = harness_ ? utils::NanoClock::Now() : 0;
+    YCSB_PROBE3(op__start, static_cast<int>(op), key.data(), key.size());
+    if (perf_) {
+      perf_->Begin();
+    }
+    if (harness_) {
+      setup_ns_ = utils::NanoClock::Now() - begin;
+    }
+    timer_.Start();
+  }
+
+  uint64_t EndEngine(Operation op) {
+    uint64_t elapsed = timer_.End();
+    if (harness_) {
+      recording_start_ = utils::NanoClock::Now();
+    }
+    if (perf_) {
+      perf_->End(op);
+    }
+    return elapsed;
+  }
+
+  void Record(Operation op, uint64_t elapsed, const std::string &key, size_t fields,
+              int scan_length = 0) {
+    YCSB_PROBE4(op__end, static_cast<int>(op), key.data(), key.size(), elapsed);
+    if (slow_ops_) {
+      slow_ops_->Add(op, elapsed, key, fields, scan_length);
+    }
+    if (samples_) {
+      samples_->Add(op, elapsed);
+    }
+    if (popularity_) {
+      popularity_->Report(op, elapsed);
+    }
+    if (working_set_) {
+      working_set_->Add(key);
+    }
+    measurements_->Report(op, elapsed);
+    if (harness_) {
+      harness_->AddEngineCall(op, elapsed, setup_ns_ + utils::NanoClock::Now() - recording_start_);
+    }
+  }
+
   DB *db_;
   Measurements *measurements_;
-  utils::Timer<uint64_t, std::micro> timer_;
+  HarnessProfile *harness_;
+  PerfCounters::Thread *perf_;
+  SlowOpLog::Thread *slow_ops_;
+  PayloadMonitor::Thread *payload_;
+  PopularityProfile *popularity_;
+  WorkingSet::Thread *working_set_;
+  LatencySampler::Thread *samples_;
+  utils::NanoTimer timer_;
+  uint64_t setup_ns_ = 0;
+  uint64_t recording_start_ = 0;
 };
 
 } // ycsbc
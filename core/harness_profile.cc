@@ -0,0 +1,107 @@
+//
+//  harness_profile.cc
+//  YCSB-cpp
+//
+
+#include "harness_profile.h"
+#include "utils/utils.h"
+
+#include <cstdio>
+
+namespace ycsbc {
+
+const std::string HarnessProfile::ENABLED_PROPERTY = "measurement.harness";
+const std::string HarnessProfile::ENABLED_DEFAULT = "false";
+
+thread_local HarnessProfile::Cost HarnessProfile::current_;
+thread_local uint64_t HarnessProfile::start_;
+
+HarnessProfile::HarnessProfile(utils::Properties *props)
+    : generation_(CreateAuxiliaryMeasurements(props)),
+      engine_(CreateAuxiliaryMeasurements(props)),
+      recording_(CreateAuxiliaryMeasurements(props)) {
+}
+
+HarnessProfile::~HarnessProfile() {
+  delete generation_;
+  delete engine_;
+  delete recording_;
+}
+
+void HarnessProfile::End() {
+  uint64_t total = utils::NanoClock::Now() - start_;
+  if (current_.op == MAXOPTYPE) {
+    return;
+  }
+  uint64_t db = current_.engine + current_.recording;
+  generation_->Report(current_.op, total > db ? total - db : 0);
+  engine_->Report(current_.op, current_.engine);
+  recording_->Report(current_.op, current_.recording);
+}
+
+namespace {
+  void PrintPart(const char *name, const OpSummary &summary) {
+    printf("  %-10s avg %9.3f us", name, summary.mean / 1000);
+    uint64_t p50, p99;
+    if (summary.Percentile(50, &p50) && summary.Percentile(99, &p99)) {
+      printf("  p50 %9.3f us  p99 %9.3f us", p50 / 1000.0, p99 / 1000.0);
+    }
+    printf("\n");
+  }
+} // anonymous
+
+void HarnessProfile::Print() {
+  printf("********** harness overhead **********\n");
+  double total[3] = {0, 0, 0};
+  for (int i = 0; i < MAXOPTYPE; i++) {
+    Operation op = static_cast<Operation>(i);
+    OpSummary generation, engine, recording;
+    if (!generation_->Summarize(op, &generation) || !engine_->Summarize(op, &engine) ||
+        !recording_->Summarize(op, &recording)) {
+      continue;
+    }
+    printf("%s: count %lu\n", kOperationString[op], generation.count);
+    PrintPart("generation", generation);
+    PrintPart("engine", engine);
+    PrintPart("recording", recording);
+    total[0] += generation.mean * generation.count;
+    total[1] += engine.mean * engine.count;
+    total[2] += recording.mean * recording.count;
+  }
+  double sum = total[0] + total[1] + total[2];
+  if (sum > 0) {
+    printf("share of op time: generation %.2f%%  engine %.2f%%  recording %.2f%%\n",
+           100 * total[0] / sum, 100 * total[1] / sum, 100 * total[2] / sum);
+  }
+  printf("**************************************\n");
+}
+
+void HarnessProfile::Export(ResultsExporter *exporter, const std::string &phase) {
+  const std::pair<const char *, Measurements *> parts[] = {
+    {"generation", generation_}, {"engine", engine_}, {"recording", recording_}};
+  for (int i = 0; i < MAXOPTYPE; i++) {
+    Operation op = static_cast<Operation>(i);
+    for (auto &part : parts) {
+      OpSummary summary;
+      if (!part.second->Summarize(op, &summary)) {
+        continue;
+      }
+      std::string prefix = std::string("harness.") + kOperationString[op] + "." + part.first;
+      exporter->AddMetric(phase, prefix + ".mean", summary.mean);
+      for (double p : {50.0, 99.0}) {
+        uint64_t v;
+        if (summary.Percentile(p, &v)) {
+          exporter->AddMetric(phase, prefix + ".p" + std::to_string(static_cast<int>(p)), v);
+        }
+      }
+    }
+  }
+}
+
+void HarnessProfile::Reset() {
+  generation_->Reset();
+  engine_->Reset();
+  recording_->Reset();
+}
+
+} // ycsbc
@@ -0,0 +1,75 @@
+//
+//  harness_profile.h
+//  YCSB-cpp
+//
+
+#ifndef YCSB_C_HARNESS_PROFILE_H_
+#define YCSB_C_HARNESS_PROFILE_H_
+
+#include <cstdint>
+#include <string>
+
+#include "measurements.h"
+#include "results_exporter.h"
+#include "utils/properties.h"
+#include "utils/timer.h"
+
+namespace ycsbc {
+
+///
+/// Splits the time of every client operation into workload generation
+/// (key choice, value building, workload bookkeeping), the engine call and
+/// the recording of its latency, each reported as a separate histogram per
+/// operation type.
+///
+/// ClientThread brackets each DoInsert()/DoTransaction() with Begin()/End();
+/// DBWrapper reports the engine and recording time of the DB calls in
+/// between with AddEngineCall(); recording includes the wrapper's monitors
+/// (perf counters, slow op log, payload, ...). Generation is the remainder.
+///
+class HarnessProfile {
+ public:
+  ///
+  /// The name of the property to enable the breakdown.
+  ///
+  static const std::string ENABLED_PROPERTY;
+  static const std::string ENABLED_DEFAULT;
+
+  HarnessProfile(utils::Properties *props);
+  ~HarnessProfile();
+
+  void Begin() {
+    current_ = Cost{MAXOPTYPE, 0, 0};
+    start_ = utils::NanoClock::Now();
+  }
+
+  void AddEngineCall(Operation op, uint64_t engine_ns, uint64_t recording_ns) {
+    current_.op = op;
+    current_.engine += engine_ns;
+    current_.recording += recording_ns;
+  }
+
+  void End();
+
+  void Print();
+  void Export(ResultsExporter *exporter, const std::string &phase);
+  void Reset();
+
+ private:
+  struct Cost {
+    Operation op; // of the last DB call, MAXOPTYPE if there was none
+    uint64_t engine;
+    uint64_t recording;
+  };
+
+  static thread_local Cost current_;
+  static thread_local uint64_t start_;
+
+  Measurements *generation_;
+  Measurements *engine_;
+  Measurements *recording_;
+};
+
+} // ycsbc
+
+#endif // YCSB_C_HARNESS_PROFILE_H_
@@ -0,0 +1,148 @@
+//
+//  latency_sampler.cc
+//  YCSB-cpp
+//
+
+#include "latency_sampler.h"
+#include "utils/utils.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <tuple>
+
+namespace ycsbc {
+
+const std::string LatencySampler::FILE_PROPERTY = "sample.file";
+const std::string LatencySampler::FILE_DEFAULT = "";
+
+const std::string LatencySampler::BUDGET_PROPERTY = "sample.budget_mb";
+const std::string LatencySampler::BUDGET_DEFAULT = "64";
+
+namespace {
+  const char kMagic[8] = {'Y', 'C', 'S', 'B', 'S', 'M', 'P', '1'};
+
+  template <typename T>
+  void PutLE(std::ofstream &out, T value) {
+    char bytes[sizeof(T)];
+    for (size_t i = 0; i < sizeof(T); i++) {
+      bytes[i] = static_cast<char>(value >> (8 * i));
+    }
+    out.write(bytes, sizeof(T));
+  }
+} // anonymous
+
+LatencySampler::Thread::Thread(size_t capacity)
+    : capacity_(capacity), seen_(0), next_(0), w_(0), rng_(std::random_device()()) {
+  reservoir_.reserve(capacity);
+}
+
+double LatencySampler::Thread::Random() {
+  // uniform in (0, 1]
+  return ((rng_() >> 11) + 1) * 0x1.0p-53;
+}
+
+void LatencySampler::Thread::Skip() {
+  double skip = std::floor(std::log(Random()) / std::log1p(-w_));
+  next_ += (skip < 1e18 ? static_cast<uint64_t>(skip) : static_cast<uint64_t>(1e18)) + 1;
+}
+
+void LatencySampler::Thread::Store(Operation op, uint64_t latency_ns) {
+  uint64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count();
+  Entry entry{now_ns - latency_ns, latency_ns, op};
+  if (seen_ <= capacity_) {
+    reservoir_.push_back(entry);
+    if (seen_ == capacity_) {
+      w_ = std::exp(std::log(Random()) / capacity_);
+      next_ = seen_;
+      Skip();
+    }
+    return;
+  }
+  reservoir_[rng_() % capacity_] = entry;
+  w_ *= std::exp(std::log(Random()) / capacity_);
+  Skip();
+}
+
+void LatencySampler::Thread::Clear() {
+  reservoir_.clear();
+  seen_ = 0;
+  next_ = 0;
+}
+
+LatencySampler::LatencySampler(utils::Properties *props, int num_threads)
+    : path_(props->GetProperty(FILE_PROPERTY, FILE_DEFAULT)), phases_(0) {
+  csv_ = path_.size() >= 4 && path_.compare(path_.size() - 4, 4, ".csv") == 0;
+  uint64_t budget = std::stoull(props->GetProperty(BUDGET_PROPERTY, BUDGET_DEFAULT)) << 20;
+  size_t capacity = budget / num_threads / sizeof(Thread::Entry);
+  if (capacity == 0) {
+    throw utils::Exception(BUDGET_PROPERTY + " is too small");
+  }
+  for (int i = 0; i < num_threads; i++) {
+    threads_.push_back(new Thread(capacity));
+  }
+}
+
+LatencySampler::~LatencySampler() {
+  for (Thread *t : threads_) {
+    delete t;
+  }
+}
+
+void LatencySampler::Dump(const std::string &phase) {
+  struct Row {
+    uint32_t thread;
+    const Thread::Entry *entry;
+  };
+  std::vector<Row> rows;
+  uint64_t seen = 0;
+  for (size_t i = 0; i < threads_.size(); i++) {
+    for (const Thread::Entry &entry : threads_[i]->reservoir_) {
+      rows.push_back(Row{static_cast<uint32_t>(i), &entry});
+    }
+    seen += threads_[i]->seen_;
+  }
+  std::sort(rows.begin(), rows.end(), [](const Row &a, const Row &b) {
+    return std::tie(a.entry->start_ns, a.thread) < std::tie(b.entry->start_ns, b.thread);
+  });
+
+  bool first = phases_ == 0;
+  std::ofstream out(path_, first ? std::ios::trunc | std::ios::binary : std::ios::app | std::ios::binary);
+  if (!out) {
+    throw utils::Exception("failed to open: " + path_);
+  }
+  if (first) {
+    if (csv_) {
+      out << "phase,thread,start_ns,op,latency_ns\n";
+    } else {
+      out.write(kMagic, sizeof(kMagic));
+    }
+  }
+  for (const Row &row : rows) {
+    const Thread::Entry &e = *row.entry;
+    if (csv_) {
+      out << phase << ',' << row.thread << ',' << e.start_ns << ',' << kOperationString[e.op] << ','
+          << e.latency_ns << '\n';
+    } else {
+      PutLE<uint64_t>(out, e.start_ns);
+      PutLE<uint64_t>(out, e.latency_ns);
+      PutLE<uint32_t>(out, row.thread);
+      PutLE<uint16_t>(out, e.op);
+      PutLE<uint16_t>(out, phases_);
+    }
+  }
+  if (!out) {
+    throw utils::Exception("failed to write: " + path_);
+  }
+  printf("latency samples: %zu of %lu operations written to %s\n", rows.size(), seen, path_.c_str());
+  phases_++;
+
+  for (Thread *t : threads_) {
+    t->Clear();
+  }
+}
+
+} // ycsbc
@@ -0,0 +1,104 @@
+//
+//  latency_sampler.h
+//  YCSB-cpp
+//
+
+#ifndef YCSB_C_LATENCY_SAMPLER_H_
+#define YCSB_C_LATENCY_SAMPLER_H_
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "core_workload.h"
+#include "utils/properties.h"
+
+namespace ycsbc {
+
+///
+/// Keeps a uniform random sample of the raw (start time, operation, latency)
+/// of every phase, for analyses histograms cannot answer such as
+/// autocorrelation or clustering of outliers.
+///
+/// Every client thread's DBWrapper samples into a reservoir of its own, sized
+/// so that all reservoirs fit sample.budget_mb. Reservoir sampling with
+/// geometric skips (Li's algorithm L) costs a counter comparison per
+/// operation and a store for the sampled ones. The reservoirs are written to
+/// sample.file at the end of each phase, sorted by time: as CSV if the name
+/// ends with .csv, else as 24-byte little-endian binary records
+///   uint64 start_ns (since the epoch), uint64 latency_ns, uint32 thread,
+///   uint16 op (Operation), uint16 phase (0 for the first phase written)
+/// after the 8-byte magic "YCSBSMP1".
+///
+class LatencySampler {
+ public:
+  ///
+  /// The name of the property for the file the samples are written to.
+  /// Nothing is sampled if empty.
+  ///
+  static const std::string FILE_PROPERTY;
+  static const std::string FILE_DEFAULT;
+
+  ///
+  /// The name of the property for the memory of all reservoirs in MB.
+  ///
+  static const std::string BUDGET_PROPERTY;
+  static const std::string BUDGET_DEFAULT;
+
+  class Thread {
+   public:
+    Thread(size_t capacity);
+
+    void Add(Operation op, uint64_t latency_ns) {
+      if (++seen_ <= capacity_ || seen_ == next_) {
+        Store(op, latency_ns);
+      }
+    }
+
+   private:
+    friend class LatencySampler;
+
+    struct Entry {
+      uint64_t start_ns; // wall clock, nanoseconds since the epoch
+      uint64_t latency_ns;
+      Operation op;
+    };
+
+    void Store(Operation op, uint64_t latency_ns);
+    double Random();
+    void Skip();
+    void Clear();
+
+    const size_t capacity_;
+    uint64_t seen_;
+    uint64_t next_; // the next operation to sample once the reservoir is full
+    double w_;
+    std::mt19937_64 rng_;
+    std::vector<Entry> reservoir_;
+  };
+
+  LatencySampler(utils::Properties *props, int num_threads);
+  ~LatencySampler();
+
+  ///
+  /// The reservoir of a client thread.
+  ///
+  Thread *ForThread(int thread_id) { return threads_[thread_id]; }
+
+  ///
+  /// Appends the samples of a finished phase to the file and empties the
+  /// reservoirs.
+  ///
+  void Dump(const std::string &phase);
+
+ private:
+  std::string path_;
+  bool csv_;
+  int phases_; // written so far
+  std::vector<Thread *> threads_;
+};
+
+} // ycsbc
+
+#endif // YCSB_C_LATENCY_SAMPLER_H_
@@ -6,8 +6,11 @@
 //
 
 #include "measurements.h"
+#include "utils/timer.h"
 #include "utils/utils.h"
 
+#include <cinttypes>
+#include <cstdlib>
 #include <limits>
 #include <numeric>
 #include <sstream>
@@ -20,11 +23,31 @@ namespace {
 #else
   const std::string MEASUREMENT_TYPE_DEFAULT = "basic";
 #endif
+
+  const std::string MEASUREMENT_INTERVAL_LOG = "measurement.histogram.log";
+  const std::string MEASUREMENT_INTERVAL_LOG_DEFAULT = "";
+
+  // read latencies from the TSC instead of clock_gettime if it is invariant
+  const std::string MEASUREMENT_TSC = "measurement.tsc";
+  const std::string MEASUREMENT_TSC_DEFAULT = "false";
+
+  // latencies are in ns; 10 ns resolution up to 100 s at 3 significant figures
+  // takes about 200 KB per histogram, with up to four per operation type
+  const int64_t kHistogramLowest = 10;
+  const int64_t kHistogramHighest = 100LL * 1000 * 1000 * 1000;
+  const int kHistogramFigures = 3;
+  // auxiliary latencies are breakdowns of the above: up to 10 s at 2 significant
+  // figures, about 25 KB per histogram
+  const int64_t kAuxiliaryHighest = 10LL * 1000 * 1000 * 1000;
+  const int kAuxiliaryFigures = 2;
 } // anonymous
 
 namespace ycsbc {
 
-BasicMeasurements::BasicMeasurements() : count_{}, latency_sum_{}, latency_max_{} {
+BasicMeasurements::BasicMeasurements()
+    : count_{}, latency_sum_{}, latency_max_{}, last_count_{}, last_latency_sum_{},
+      interval_count_{}, interval_latency_sum_{},
+      interval_start_(std::chrono::steady_clock::now()), interval_sec_(0) {
   std::fill(std::begin(latency_min_), std::end(latency_min_), std::numeric_limits<uint64_t>::max());
 }
 
@@ -69,19 +92,145 @@ void BasicMeasurements::Reset() {
   std::fill(std::begin(latency_sum_), std::end(latency_sum_), 0);
   std::fill(std::begin(latency_min_), std::end(latency_min_), std::numeric_limits<uint64_t>::max());
   std::fill(std::begin(latency_max_), std::end(latency_max_), 0);
+  std::fill(std::begin(last_count_), std::end(last_count_), 0);
+  std::fill(std::begin(last_latency_sum_), std::end(last_latency_sum_), 0);
+}
+
+bool BasicMeasurements::Summarize(Operation op, OpSummary *summary) {
+  uint64_t cnt = count_[op].load(std::memory_order_relaxed);
+  if (cnt == 0) {
+    return false;
+  }
+  summary->count = cnt;
+  summary->mean = static_cast<double>(latency_sum_[op].load(std::memory_order_relaxed)) / cnt;
+  summary->min = latency_min_[op].load(std::memory_order_relaxed);
+  summary->max = latency_max_[op].load(std::memory_order_relaxed);
+  summary->percentiles.clear();
+  return true;
+}
+
+bool BasicMeasurements::SummarizeInterval(Operation op, OpSummary *summary) {
+  uint64_t cnt = interval_count_[op];
+  if (cnt == 0) {
+    return false;
+  }
+  summary->count = cnt;
+  summary->mean = static_cast<double>(interval_latency_sum_[op]) / cnt;
+  // only kept for the whole run
+  summary->min = 0;
+  summary->max = 0;
+  summary->percentiles.clear();
+  return true;
+}
+
+void BasicMeasurements::FinishInterval() {
+  std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+  interval_sec_ = std::chrono::duration<double>(now - interval_start_).count();
+  interval_start_ = now;
+  for (int op = 0; op < MAXOPTYPE; op++) {
+    uint64_t cnt = count_[op].load(std::memory_order_relaxed);
+    uint64_t sum = latency_sum_[op].load(std::memory_order_relaxed);
+    interval_count_[op] = cnt - std::min(cnt, last_count_[op]);
+    interval_latency_sum_[op] = sum - std::min(sum, last_latency_sum_[op]);
+    last_count_[op] = cnt;
+    last_latency_sum_[op] = sum;
+  }
+}
+
+std::string BasicMeasurements::GetIntervalStatusMsg() {
+  std::ostringstream msg_stream;
+  msg_stream.precision(2);
+  uint64_t total_cnt = 0;
+  msg_stream << std::fixed;
+  for (int i = 0; i < MAXOPTYPE; i++) {
+    Operation op = static_cast<Operation>(i);
+    uint64_t cnt = interval_count_[op];
+    if (cnt == 0)
+      continue;
+    msg_stream << " [" << kOperationString[op] << ":"
+               << " OPS=" << (interval_sec_ > 0 ? cnt / interval_sec_ : 0)
+               << " Avg=" << static_cast<double>(interval_latency_sum_[op]) / cnt / 1000.0
+               << " us]";
+    total_cnt += cnt;
+  }
+  std::ostringstream head;
+  head.precision(2);
+  head << std::fixed << " interval " << interval_sec_ << " sec: "
+       << (interval_sec_ > 0 ? total_cnt / interval_sec_ : 0) << " ops/sec;";
+  return head.str() + msg_stream.str();
 }
 
 #ifdef HDRMEASUREMENT
-HdrHistogramMeasurements::HdrHistogramMeasurements() {
+HdrHistogramMeasurements::HdrHistogramMeasurements(const std::string &interval_log, int64_t highest,
+                                                   int significant_figures)
+    : log_file_(nullptr) {
   for (int op = 0; op < MAXOPTYPE; op++) {
-    if (hdr_init(10, 100LL * 1000 * 1000 * 1000, 3, &histogram_[op]) != 0) {
-      utils::Exception("hdr init failed");
+    if (hdr_init(kHistogramLowest, highest, significant_figures, &histogram_[op]) != 0) {
+      throw utils::Exception("hdr init failed");
     }
+    if (hdr_interval_recorder_init_all(&recorder_[op], kHistogramLowest, highest, significant_figures) != 0) {
+      throw utils::Exception("hdr interval recorder init failed");
+    }
+    interval_[op] = nullptr;
+  }
+  hdr_gettime(&log_start_);
+  interval_start_ = log_start_;
+  interval_sec_ = 0;
+
+  if (!interval_log.empty()) {
+    log_file_ = fopen(interval_log.c_str(), "w");
+    if (log_file_ == nullptr) {
+      throw utils::Exception("failed to open: " + interval_log);
+    }
+    hdr_log_writer writer;
+    hdr_log_writer_init(&writer);
+    hdr_log_write_header(&writer, log_file_, "YCSB-cpp latency (ns)", &log_start_);
+    fprintf(log_file_, "#[BaseTime: %.3f (seconds since epoch)]\n", hdr_timespec_as_double(&log_start_));
+    fflush(log_file_);
+  }
+}
+
+HdrHistogramMeasurements::~HdrHistogramMeasurements() {
+  if (log_file_ != nullptr) {
+    fclose(log_file_);
+  }
+  for (int op = 0; op < MAXOPTYPE; op++) {
+    hdr_close(histogram_[op]);
+    hdr_interval_recorder_destroy(&recorder_[op]);
   }
 }
 
 void HdrHistogramMeasurements::Report(Operation op, uint64_t latency) {
   hdr_record_value_atomic(histogram_[op], latency);
+  hdr_interval_recorder_record_value_atomic(&recorder_[op], latency);
+}
+
+void HdrHistogramMeasurements::FinishInterval() {
+  hdr_timespec now;
+  hdr_gettime(&now);
+  double start = hdr_timespec_as_double(&interval_start_) - hdr_timespec_as_double(&log_start_);
+  double length = hdr_timespec_as_double(&now) - hdr_timespec_as_double(&interval_start_);
+  interval_sec_ = length;
+  for (int op = 0; op < MAXOPTYPE; op++) {
+    interval_[op] = hdr_interval_recorder_sample_and_recycle(&recorder_[op], interval_[op]);
+    if (log_file_ == nullptr || interval_[op]->total_count == 0) {
+      continue;
+    }
+    // tagged lines (log format 1.3) keep all phases and operation types in one file,
+    // e.g. Tag=run.READ
+    char *encoded = nullptr;
+    if (hdr_log_encode(interval_[op], &encoded) != 0) {
+      throw utils::Exception("hdr log encode failed");
+    }
+    std::string tag = phase_.empty() ? kOperationString[op] : phase_ + "." + kOperationString[op];
+    fprintf(log_file_, "Tag=%s,%.3f,%.3f,%" PRId64 ".0,%s\n", tag.c_str(), start, length,
+            hdr_max(interval_[op]), encoded);
+    free(encoded);
+  }
+  if (log_file_ != nullptr) {
+    fflush(log_file_);
+  }
+  interval_start_ = now;
 }
 
 std::string HdrHistogramMeasurements::GetStatusMsg() {
@@ -99,31 +248,82 @@ std::string HdrHistogramMeasurements::GetStatusMsg() {
                << " Count = " << cnt
                << std::endl
                << " Max = " << hdr_max(histogram_[op]) / 1000.0
-               << " ms"
+               << " us"
                << std::endl
                << " Min = " << hdr_min(histogram_[op]) / 1000.0
-               << " ms"
+               << " us"
                << std::endl
                << " Avg = " << hdr_mean(histogram_[op]) / 1000.0
-               << " ms"
+               << " us"
                << std::endl
                << " 90 = " << hdr_value_at_percentile(histogram_[op], 90) / 1000.0
-               << " ms"
+               << " us"
                << std::endl
                << " 99 = " << hdr_value_at_percentile(histogram_[op], 99) / 1000.0
-               << " ms"
+               << " us"
                << std::endl
                << " 99.9 = " << hdr_value_at_percentile(histogram_[op], 99.9) / 1000.0
-               << " ms"
+               << " us"
                << std::endl
                << " 99.99 = " << hdr_value_at_percentile(histogram_[op], 99.99) / 1000.0
-               << " ms"
+               << " us"
                << "]";
     total_cnt += cnt;
   }
   return std::to_string(total_cnt) + msg_stream.str();
 }
 
+std::string HdrHistogramMeasurements::GetIntervalStatusMsg() {
+  std::ostringstream msg_stream;
+  msg_stream.precision(2);
+  uint64_t total_cnt = 0;
+  msg_stream << std::fixed;
+  for (int i = 0; i < MAXOPTYPE; i++) {
+    Operation op = static_cast<Operation>(i);
+    if (interval_[op] == nullptr || interval_[op]->total_count == 0)
+      continue;
+    uint64_t cnt = interval_[op]->total_count;
+    msg_stream << " [" << kOperationString[op] << ":"
+               << " OPS=" << (interval_sec_ > 0 ? cnt / interval_sec_ : 0)
+               << " 50=" << hdr_value_at_percentile(interval_[op], 50) / 1000.0
+               << " 99=" << hdr_value_at_percentile(interval_[op], 99) / 1000.0
+               << " 99.9=" << hdr_value_at_percentile(interval_[op], 99.9) / 1000.0
+               << " us]";
+    total_cnt += cnt;
+  }
+  std::ostringstream head;
+  head.precision(2);
+  head << std::fixed << " interval " << interval_sec_ << " sec: "
+       << (interval_sec_ > 0 ? total_cnt / interval_sec_ : 0) << " ops/sec;";
+  return head.str() + msg_stream.str();
+}
+
+namespace {
+  bool SummarizeHistogram(hdr_histogram *histogram, OpSummary *summary) {
+    static const double kPercentiles[] = {1, 5, 10, 25, 50, 75, 90, 95, 99, 99.9, 99.99, 99.999};
+    if (histogram == nullptr || histogram->total_count == 0) {
+      return false;
+    }
+    summary->count = histogram->total_count;
+    summary->mean = hdr_mean(histogram);
+    summary->min = hdr_min(histogram);
+    summary->max = hdr_max(histogram);
+    summary->percentiles.clear();
+    for (double p : kPercentiles) {
+      summary->percentiles.emplace_back(p, hdr_value_at_percentile(histogram, p));
+    }
+    return true;
+  }
+} // anonymous
+
+bool HdrHistogramMeasurements::Summarize(Operation op, OpSummary *summary) {
+  return SummarizeHistogram(histogram_[op], summary);
+}
+
+bool HdrHistogramMeasurements::SummarizeInterval(Operation op, OpSummary *summary) {
+  return SummarizeHistogram(interval_[op], summary);
+}
+
 void HdrHistogramMeasurements::Reset() {
   for (int op = 0; op < MAXOPTYPE; op++) {
     hdr_reset(histogram_[op]);
@@ -135,12 +335,20 @@ Measurements *CreateMeasurements(utils::Properties *props) {
   std::string name = props->GetProperty(MEASUREMENT_TYPE, MEASUREMENT_TYPE_DEFAULT);
   std::ostringstream msg_stream;
   std::cout << "name: " << name << std::endl;
+  utils::NanoClock::Init(utils::StrToBool(props->GetProperty(MEASUREMENT_TSC, MEASUREMENT_TSC_DEFAULT)));
+  if (utils::NanoClock::UsingTsc()) {
+    std::cout << "latency clock: tsc " << utils::NanoClock::TscGhz() << " GHz" << std::endl;
+  } else {
+    std::cout << "latency clock: clock_gettime(CLOCK_MONOTONIC)" << std::endl;
+  }
   Measurements *measurements;
   if (name == "basic") {
     measurements = new BasicMeasurements();
 #ifdef HDRMEASUREMENT
   } else if (name == "hdrhistogram") {
-    measurements = new HdrHistogramMeasurements();
+    measurements = new HdrHistogramMeasurements(props->GetProperty(MEASUREMENT_INTERVAL_LOG,
+                                                                   MEASUREMENT_INTERVAL_LOG_DEFAULT),
+                                                kHistogramHighest, kHistogramFigures);
 #endif
   } else {
     measurements = nullptr;
@@ -149,4 +357,14 @@ Measurements *CreateMeasurements(utils::Properties *props) {
   return measurements;
 }
 
+Measurements *CreateAuxiliaryMeasurements(utils::Properties *props) {
+  std::string name = props->GetProperty(MEASUREMENT_TYPE, MEASUREMENT_TYPE_DEFAULT);
+#ifdef HDRMEASUREMENT
+  if (name == "hdrhistogram") {
+    return new HdrHistogramMeasurements("", kAuxiliaryHighest, kAuxiliaryFigures);
+  }
+#endif
+  return new BasicMeasurements();
+}
+
 } // ycsbc
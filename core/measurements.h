@@ -12,20 +12,76 @@
 #include "utils/properties.h"
 
 #include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
 
 #ifdef HDRMEASUREMENT
 #include <hdr/hdr_histogram.h>
+#include <hdr/hdr_histogram_log.h>
+#include <hdr/hdr_interval_recorder.h>
 #endif
 
 typedef unsigned int uint;
 
 namespace ycsbc {
 
+///
+/// Latency summary of one operation type, in the unit passed to Report().
+///
+struct OpSummary {
+  uint64_t count;
+  double mean;
+  uint64_t min;
+  uint64_t max;
+  std::vector<std::pair<double, uint64_t>> percentiles; // (percentile, latency), if available
+
+  ///
+  /// Looks up the latency at percentile p.
+  /// @return false, leaving latency unchanged, if p was not recorded.
+  ///
+  bool Percentile(double p, uint64_t *latency) const {
+    for (auto &v : percentiles) {
+      if (v.first == p) {
+        *latency = v.second;
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
 class Measurements {
  public:
+  virtual ~Measurements() { }
   virtual void Report(Operation op, uint64_t latency) = 0;
   virtual std::string GetStatusMsg() = 0;
   virtual void Reset() = 0;
+  ///
+  /// Names the phase the following intervals belong to.
+  ///
+  virtual void StartPhase(const std::string &phase) { }
+  ///
+  /// Closes the current measurement interval.
+  /// Called by the status thread on every tick and once at the end of a phase.
+  ///
+  virtual void FinishInterval() { }
+  ///
+  /// Throughput and latency of the last finished interval.
+  ///
+  virtual std::string GetIntervalStatusMsg() { return ""; }
+  ///
+  /// Fills summary with the latencies of op since the last Reset().
+  /// Returns false if none were recorded.
+  ///
+  virtual bool Summarize(Operation op, OpSummary *summary) = 0;
+  ///
+  /// Fills summary with the latencies of op in the last finished interval.
+  /// Returns false if none were recorded or intervals are not kept.
+  ///
+  virtual bool SummarizeInterval(Operation op, OpSummary *summary) { return false; }
 };
 
 class BasicMeasurements : public Measurements {
@@ -34,27 +90,62 @@ class BasicMeasurements : public Measurements {
   void Report(Operation op, uint64_t latency) override;
   std::string GetStatusMsg() override;
   void Reset() override;
+  void FinishInterval() override;
+  std::string GetIntervalStatusMsg() override;
+  bool Summarize(Operation op, OpSummary *summary) override;
+  bool SummarizeInterval(Operation op, OpSummary *summary) override;
  private:
   std::atomic<uint> count_[MAXOPTYPE];
   std::atomic<uint64_t> latency_sum_[MAXOPTYPE];
   std::atomic<uint64_t> latency_min_[MAXOPTYPE];
   std::atomic<uint64_t> latency_max_[MAXOPTYPE];
+  // totals at the end of the last interval and the deltas within it
+  uint64_t last_count_[MAXOPTYPE];
+  uint64_t last_latency_sum_[MAXOPTYPE];
+  uint64_t interval_count_[MAXOPTYPE];
+  uint64_t interval_latency_sum_[MAXOPTYPE];
+  std::chrono::steady_clock::time_point interval_start_;
+  double interval_sec_;
 };
 
 #ifdef HDRMEASUREMENT
 class HdrHistogramMeasurements : public Measurements {
  public:
-  HdrHistogramMeasurements();
+  ///
+  /// @param interval_log Path of the HdrHistogram interval log, empty for none.
+  /// @param highest The highest trackable latency in ns; larger ones are dropped.
+  /// @param significant_figures The precision of the histograms.
+  ///
+  HdrHistogramMeasurements(const std::string &interval_log, int64_t highest, int significant_figures);
+  ~HdrHistogramMeasurements();
   void Report(Operation op, uint64_t latency) override;
   std::string GetStatusMsg() override;
   void Reset() override;
+  void StartPhase(const std::string &phase) override { phase_ = phase; }
+  void FinishInterval() override;
+  std::string GetIntervalStatusMsg() override;
+  bool Summarize(Operation op, OpSummary *summary) override;
+  bool SummarizeInterval(Operation op, OpSummary *summary) override;
  private:
   hdr_histogram *histogram_[MAXOPTYPE];
+  hdr_interval_recorder recorder_[MAXOPTYPE];
+  hdr_histogram *interval_[MAXOPTYPE]; // last finished interval, recycled
+  hdr_timespec log_start_;
+  hdr_timespec interval_start_;
+  double interval_sec_;
+  FILE *log_file_;
+  std::string phase_; // read by the status thread, set between phases
 };
 #endif
 
 Measurements *CreateMeasurements(utils::Properties *props);
 
+///
+/// Creates measurements of the configured type without an interval log,
+/// for latencies other than those of the operations themselves.
+///
+Measurements *CreateAuxiliaryMeasurements(utils::Properties *props);
+
 } // ycsbc
 
 #endif // YCSB_C_MEASUREMENTS
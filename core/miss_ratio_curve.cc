@@ -0,0 +1,137 @@
+//
+//  miss_ratio_curve.cc
+//  YCSB-cpp
+//
+
+#include "miss_ratio_curve.h"
+#include "core_workload.h"
+#include "utils/utils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+
+namespace ycsbc {
+
+const std::string MissRatioCurve::RATE_PROPERTY = "mrc.rate";
+const std::string MissRatioCurve::RATE_DEFAULT = "0";
+
+const std::string MissRatioCurve::FILE_PROPERTY = "mrc.file";
+const std::string MissRatioCurve::FILE_DEFAULT = "";
+
+namespace {
+  const int kModulusBits = 24;
+  const uint64_t kSampledKeys = 1 << 17;
+  const int kPrintPoints = 20;
+  const int kFilePoints = 200;
+} // anonymous
+
+MissRatioCurve::MissRatioCurve(utils::Properties *props)
+    : record_bytes_(CoreWorkload::EstimatedRecordBytes(*props)),
+      file_(props->GetProperty(FILE_PROPERTY, FILE_DEFAULT)), references_(0), tree_(1024), time_(0) {
+  rate_ = std::stod(props->GetProperty(RATE_PROPERTY, RATE_DEFAULT));
+  if (rate_ <= 0) {
+    uint64_t record_count = std::stoull(props->GetProperty(CoreWorkload::RECORD_COUNT_PROPERTY, "0"));
+    rate_ = record_count > kSampledKeys ? 1.0 * kSampledKeys / record_count : 1.0;
+  }
+  if (rate_ > 1) {
+    throw utils::Exception(RATE_PROPERTY + " must be at most 1");
+  }
+  threshold_ = std::max<uint64_t>(1, std::llround(rate_ * (1ull << kModulusBits)));
+  rate_ = 1.0 * threshold_ / (1ull << kModulusBits);
+}
+
+void MissRatioCurve::Mark(uint64_t time, int delta) {
+  for (uint64_t i = time; i < tree_.size(); i += i & -i) {
+    tree_[i] += delta;
+  }
+}
+
+uint64_t MissRatioCurve::CountAfter(uint64_t time) const {
+  uint64_t before = 0;
+  for (uint64_t i = time; i > 0; i -= i & -i) {
+    before += tree_[i];
+  }
+  return last_.size() - before;
+}
+
+void MissRatioCurve::Grow() {
+  tree_.assign(tree_.size() * 2, 0);
+  for (auto &entry : last_) {
+    Mark(entry.second, 1);
+  }
+}
+
+void MissRatioCurve::Add(uint64_t key_num) {
+  references_++;
+  // the key is sampled if its hash falls below the threshold, so every
+  // reference of a sampled key is seen
+  if (((utils::Hash(key_num) * 0x9e3779b97f4a7c15ull) >> (64 - kModulusBits)) >= threshold_) {
+    return;
+  }
+  uint64_t now = ++time_;
+  if (now >= tree_.size()) {
+    Grow();
+  }
+  auto it = last_.find(key_num);
+  if (it == last_.end()) {
+    last_.emplace(key_num, now);
+    Mark(now, 1);
+    return;
+  }
+  uint64_t distance = CountAfter(it->second);
+  if (distance >= distances_.size()) {
+    distances_.resize(distance + 1, 0);
+  }
+  distances_[distance]++;
+  Mark(it->second, -1);
+  Mark(now, 1);
+  it->second = now;
+}
+
+double MissRatioCurve::HitRatio(uint64_t records) const {
+  double expected = references_ * rate_;
+  if (records == 0 || expected <= 0) {
+    return 0;
+  }
+  // a reference hits if fewer than records distinct keys were used since
+  // the last reference of its key
+  uint64_t limit = std::min<uint64_t>(std::ceil(records * rate_), distances_.size());
+  double hits = 0;
+  for (uint64_t d = 0; d < limit; d++) {
+    hits += distances_[d];
+  }
+  // SHARDS adjustment: the sample over- or under-represents the stream, the
+  // difference is attributed to the shortest distances
+  hits += expected - time_;
+  return std::min(1.0, std::max(0.0, hits / expected));
+}
+
+void MissRatioCurve::Print() {
+  uint64_t keys = std::llround(last_.size() / rate_);
+  printf("********** miss ratio curve **********\n");
+  printf("references: %lu  distinct keys (est.): %lu  sampling rate: %.6f  record size (est.): %lu bytes\n",
+         references_, keys, rate_, record_bytes_);
+  for (int i = 1; i <= kPrintPoints; i++) {
+    uint64_t records = keys * i / kPrintPoints;
+    double hit = HitRatio(records);
+    printf("cache %10.2f MB  %12lu records  hit ratio %.4f  miss ratio %.4f\n",
+           records * record_bytes_ / utils::kMB, records, hit, 1 - hit);
+  }
+  printf("**************************************\n");
+  if (file_ == "") {
+    return;
+  }
+  std::ofstream out(file_, std::ios::trunc);
+  if (!out) {
+    throw utils::Exception("cannot open " + file_);
+  }
+  out << "cache_bytes,records,hit_ratio\n";
+  for (int i = 0; i <= kFilePoints; i++) {
+    uint64_t records = keys * i / kFilePoints;
+    out << records * record_bytes_ << "," << records << "," << HitRatio(records) << "\n";
+  }
+}
+
+} // ycsbc
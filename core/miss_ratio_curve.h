@@ -0,0 +1,72 @@
+//
+//  miss_ratio_curve.h
+//  YCSB-cpp
+//
+
+#ifndef YCSB_C_MISS_RATIO_CURVE_H_
+#define YCSB_C_MISS_RATIO_CURVE_H_
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "utils/properties.h"
+
+namespace ycsbc {
+
+///
+/// Predicts the hit ratio of an LRU record cache of any size for a key
+/// stream, without running an engine. Stack (reuse) distances are computed
+/// exactly for a spatially hashed sample of the keys (SHARDS, fixed rate) and
+/// scaled by the sampling rate; cache sizes in bytes assume every record
+/// takes the estimated record size. First accesses count as misses.
+///
+class MissRatioCurve {
+ public:
+  ///
+  /// The fraction of keys sampled; 0 picks a rate that tracks about 2^17
+  /// keys of the recordcount.
+  ///
+  static const std::string RATE_PROPERTY;
+  static const std::string RATE_DEFAULT;
+
+  ///
+  /// The CSV file the curve is written to, if set.
+  ///
+  static const std::string FILE_PROPERTY;
+  static const std::string FILE_DEFAULT;
+
+  MissRatioCurve(utils::Properties *props);
+
+  void Add(uint64_t key_num);
+
+  ///
+  /// The predicted hit ratio of a cache holding records records.
+  ///
+  double HitRatio(uint64_t records) const;
+
+  void Print();
+
+ private:
+  void Mark(uint64_t time, int delta);
+  uint64_t CountAfter(uint64_t time) const;
+  void Grow();
+
+  double rate_;
+  uint64_t threshold_;
+  uint64_t record_bytes_;
+  std::string file_;
+  uint64_t references_;
+  // last sampled reference time of every sampled key
+  std::unordered_map<uint64_t, uint64_t> last_;
+  // Fenwick tree over the sampled reference times, marking the last ones
+  std::vector<int> tree_;
+  uint64_t time_;
+  // sampled references by sampled stack distance
+  std::vector<uint64_t> distances_;
+};
+
+} // ycsbc
+
+#endif // YCSB_C_MISS_RATIO_CURVE_H_
@@ -0,0 +1,120 @@
+//
+//  payload_monitor.cc
+//  YCSB-cpp
+//
+
+#include "payload_monitor.h"
+#include "utils/utils.h"
+
+#include <cstdio>
+
+namespace ycsbc {
+
+namespace {
+  // mean latency per returned record in ns, -1 if unknown
+  double PerRecordLatency(Measurements *measurements, Operation op, uint64_t records) {
+    OpSummary summary;
+    if (records == 0 || !measurements->Summarize(op, &summary)) {
+      return -1;
+    }
+    return summary.mean * summary.count / records;
+  }
+} // anonymous
+
+PayloadMonitor::PayloadMonitor(int num_threads) {
+  for (int i = 0; i < num_threads; i++) {
+    threads_.push_back(new Thread());
+  }
+  StartPhase();
+}
+
+PayloadMonitor::~PayloadMonitor() {
+  for (Thread *t : threads_) {
+    delete t;
+  }
+}
+
+void PayloadMonitor::Totals(Counts *totals) const {
+  for (int op = 0; op < MAXOPTYPE; op++) {
+    totals[op] = Counts{0, 0, 0, 0};
+    for (Thread *t : threads_) {
+      const Counts &c = t->counts_[op];
+      totals[op].ops += c.ops;
+      totals[op].request_bytes += c.request_bytes;
+      totals[op].response_bytes += c.response_bytes;
+      totals[op].records += c.records;
+    }
+  }
+}
+
+void PayloadMonitor::StartPhase() {
+  Totals(phase_start_);
+}
+
+void PayloadMonitor::PhaseCounts(Counts *counts) const {
+  Totals(counts);
+  for (int op = 0; op < MAXOPTYPE; op++) {
+    counts[op].ops -= phase_start_[op].ops;
+    counts[op].request_bytes -= phase_start_[op].request_bytes;
+    counts[op].response_bytes -= phase_start_[op].response_bytes;
+    counts[op].records -= phase_start_[op].records;
+  }
+}
+
+void PayloadMonitor::Print(double runtime_sec, Measurements *measurements) {
+  Counts counts[MAXOPTYPE];
+  PhaseCounts(counts);
+  double total_bytes = 0;
+  printf("********** payload **********\n");
+  for (int i = 0; i < MAXOPTYPE; i++) {
+    Operation op = static_cast<Operation>(i);
+    const Counts &c = counts[op];
+    if (c.ops == 0) {
+      continue;
+    }
+    double bytes = c.request_bytes + c.response_bytes;
+    total_bytes += bytes;
+    printf("%s: request %.2f MB  response %.2f MB  %.2f MB/s  %.1f bytes/op", kOperationString[op],
+           c.request_bytes / utils::kMB, c.response_bytes / utils::kMB, runtime_sec > 0 ? bytes / utils::kMB / runtime_sec : 0,
+           bytes / c.ops);
+    if (op == SCAN) {
+      printf("  records %lu (%.1f/scan)", c.records, 1.0 * c.records / c.ops);
+      double per_record = PerRecordLatency(measurements, op, c.records);
+      if (per_record >= 0) {
+        printf("  %.3f us/record", per_record / 1000);
+      }
+    }
+    printf("\n");
+  }
+  printf("total: %.2f MB  %.2f MB/s\n", total_bytes / utils::kMB, runtime_sec > 0 ? total_bytes / utils::kMB / runtime_sec : 0);
+  printf("*****************************\n");
+}
+
+void PayloadMonitor::Export(ResultsExporter *exporter, const std::string &phase, double runtime_sec,
+                            Measurements *measurements) {
+  Counts counts[MAXOPTYPE];
+  PhaseCounts(counts);
+  for (int i = 0; i < MAXOPTYPE; i++) {
+    Operation op = static_cast<Operation>(i);
+    const Counts &c = counts[op];
+    if (c.ops == 0) {
+      continue;
+    }
+    std::string prefix = std::string("payload.") + kOperationString[op] + ".";
+    exporter->AddMetric(phase, prefix + "request_bytes", c.request_bytes);
+    exporter->AddMetric(phase, prefix + "response_bytes", c.response_bytes);
+    if (runtime_sec > 0) {
+      exporter->AddMetric(phase, prefix + "mb_per_sec",
+                          (c.request_bytes + c.response_bytes) / utils::kMB / runtime_sec);
+    }
+    if (op == SCAN) {
+      exporter->AddMetric(phase, prefix + "records", c.records);
+      double per_record = PerRecordLatency(measurements, op, c.records);
+      if (per_record >= 0) {
+        exporter->AddMetric(phase, prefix + "latency_per_record", per_record);
+      }
+    }
+  }
+}
+
+} // ycsbc
@@ -0,0 +1,130 @@
+//
+//  payload_monitor.h
+//  YCSB-cpp
+//
+
+#ifndef YCSB_C_PAYLOAD_MONITOR_H_
+#define YCSB_C_PAYLOAD_MONITOR_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "core_workload.h"
+#include "db.h"
+#include "measurements.h"
+#include "results_exporter.h"
+
+namespace ycsbc {
+
+///
+/// Accounts the payload of successful operations per operation type, so
+/// engines can be compared by MB/s and not only by ops/sec. Request bytes are
+/// the key and the field names and values sent (only the names for reads and
+/// scans); response bytes are the field names and values returned.
+///
+/// Every client thread's DBWrapper counts into a Thread of its own; the
+/// totals are only read while the client threads are idle.
+///
+class PayloadMonitor {
+ public:
+  struct Counts {
+    uint64_t ops;
+    uint64_t request_bytes;
+    uint64_t response_bytes;
+    uint64_t records; // returned, for scans and reads
+  };
+
+  class Thread {
+   public:
+    void AddWrite(Operation op, const std::string &key, const std::vector<DB::Field> &values) {
+      Counts &c = counts_[op];
+      c.ops++;
+      c.request_bytes += key.size() + Bytes(values);
+    }
+
+    void AddRead(Operation op, const std::string &key, const std::vector<std::string> *fields,
+                 const std::vector<DB::Field> &result) {
+      Counts &c = counts_[op];
+      c.ops++;
+      c.request_bytes += key.size() + Bytes(fields);
+      c.response_bytes += Bytes(result);
+      c.records++;
+    }
+
+    void AddScan(Operation op, const std::string &key, const std::vector<std::string> *fields,
+                 const std::vector<std::vector<DB::Field>> &result) {
+      Counts &c = counts_[op];
+      c.ops++;
+      c.request_bytes += key.size() + Bytes(fields);
+      for (const std::vector<DB::Field> &record : result) {
+        c.response_bytes += Bytes(record);
+      }
+      c.records += result.size();
+    }
+
+    void AddReadModifyWrite(Operation op, const std::string &key, const std::vector<DB::Field> &result,
+                            const std::vector<DB::Field> &values) {
+      Counts &c = counts_[op];
+      c.ops++;
+      c.request_bytes += key.size() + Bytes(values);
+      c.response_bytes += Bytes(result);
+      c.records++;
+    }
+
+   private:
+    friend class PayloadMonitor;
+
+    static uint64_t Bytes(const std::vector<DB::Field> &fields) {
+      uint64_t bytes = 0;
+      for (const DB::Field &field : fields) {
+        bytes += field.name.size() + field.value.size();
+      }
+      return bytes;
+    }
+    static uint64_t Bytes(const std::vector<std::string> *names) {
+      uint64_t bytes = 0;
+      if (names) {
+        for (const std::string &name : *names) {
+          bytes += name.size();
+        }
+      }
+      return bytes;
+    }
+
+    Counts counts_[MAXOPTYPE] = {};
+  };
+
+  PayloadMonitor(int num_threads);
+  ~PayloadMonitor();
+
+  Thread *ForThread(int thread_id) { return threads_[thread_id]; }
+
+  ///
+  /// The counts of all threads since the start of the process.
+  ///
+  void Totals(Counts *totals) const;
+
+  ///
+  /// Takes the baseline of a phase.
+  ///
+  void StartPhase();
+
+  ///
+  /// Prints the payload of the phase, given its runtime and its latencies
+  /// for the per-record latency of scans.
+  ///
+  void Print(double runtime_sec, Measurements *measurements);
+  void Export(ResultsExporter *exporter, const std::string &phase, double runtime_sec,
+              Measurements *measurements);
+
+ private:
+  void PhaseCounts(Counts *counts) const;
+
+  std::vector<Thread *> threads_;
+  Counts phase_start_[MAXOPTYPE];
+};
+
+} // ycsbc
+
+#endif // YCSB_C_PAYLOAD_MONITOR_H_
@@ -0,0 +1,245 @@
+//
+//  perf_counters.cc
+//  YCSB-cpp
+//
+
+#include "perf_counters.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace ycsbc {
+
+const std::string PerfCounters::ENABLED_PROPERTY = "measurement.perfcounters";
+const std::string PerfCounters::ENABLED_DEFAULT = "false";
+
+namespace {
+  const char *kEventName[PerfCounters::MAXEVENT] = {
+    "cycles", "instructions", "llc_misses", "branch_misses"
+  };
+#ifdef __linux__
+  const uint64_t kEventConfig[PerfCounters::MAXEVENT] = {
+    PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES
+  };
+#endif
+} // anonymous
+
+#ifdef __linux__
+int PerfCounters::OpenEvent(Event event, bool exclude_kernel, int group_fd) {
+  perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = kEventConfig[event];
+  attr.exclude_kernel = exclude_kernel;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_GROUP;
+  // the calling thread, on any cpu
+  return syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0);
+}
+#endif
+
+PerfCounters::PerfCounters(int num_threads) : exclude_kernel_(false) {
+  std::string error;
+#ifdef __linux__
+  // probe the group once, events that cannot join it are left out
+  for (int attempt = 0; attempt < 2; attempt++) {
+    // retry without kernel time if perf_event_paranoid refuses it
+    exclude_kernel_ = attempt > 0;
+    available_.clear();
+    bool denied = false;
+    int leader = -1;
+    for (int e = 0; e < MAXEVENT; e++) {
+      int fd = OpenEvent(static_cast<Event>(e), exclude_kernel_, leader);
+      if (fd < 0) {
+        denied = denied || errno == EACCES || errno == EPERM;
+        error = std::string(kEventName[e]) + ": " + strerror(errno);
+        continue;
+      }
+      available_.push_back(static_cast<Event>(e));
+      if (leader < 0) {
+        leader = fd;
+      } else {
+        close(fd);
+      }
+    }
+    if (leader >= 0) {
+      close(leader);
+    }
+    if (!denied) {
+      break;
+    }
+  }
+#else
+  error = "perf events need Linux";
+#endif
+
+  if (available_.empty()) {
+    printf("perf counters: unavailable (%s)\n", error.c_str());
+    return;
+  }
+  printf("perf counters:");
+  for (Event e : available_) {
+    printf(" %s", kEventName[e]);
+  }
+  printf(" (%s)\n", exclude_kernel_ ? "user only" : "user and kernel");
+  for (int i = 0; i < num_threads; i++) {
+    threads_.push_back(new Thread(this));
+  }
+}
+
+PerfCounters::~PerfCounters() {
+  for (Thread *t : threads_) {
+    delete t;
+  }
+}
+
+#ifdef __linux__
+bool PerfCounters::Thread::Open() {
+  std::thread::id self = std::this_thread::get_id();
+  if (owner_ == self) {
+    return leader_ >= 0;
+  }
+  // a new client thread (e.g. of the next phase) reuses the DB
+  Close();
+  owner_ = self;
+  for (Event e : parent_->available_) {
+    int fd = OpenEvent(e, parent_->exclude_kernel_, leader_);
+    if (fd < 0) {
+      Close();
+      return false;
+    }
+    if (leader_ < 0) {
+      leader_ = fd;
+    }
+    fds_.push_back(fd);
+  }
+  return true;
+}
+
+void PerfCounters::Thread::Close() {
+  for (int fd : fds_) {
+    close(fd);
+  }
+  fds_.clear();
+  leader_ = -1;
+}
+
+bool PerfCounters::Thread::ReadGroup(uint64_t *values) {
+  // PERF_FORMAT_GROUP: the number of events, then their values in group order
+  uint64_t buf[1 + MAXEVENT];
+  ssize_t n = read(leader_, buf, sizeof(buf));
+  if (n < static_cast<ssize_t>(sizeof(uint64_t)) || buf[0] != fds_.size()) {
+    return false;
+  }
+  memcpy(values, buf + 1, fds_.size() * sizeof(uint64_t));
+  return true;
+}
+#else
+// never called, ForThread() returns nullptr without events
+bool PerfCounters::Thread::Open() {
+  return false;
+}
+
+void PerfCounters::Thread::Close() {
+}
+
+bool PerfCounters::Thread::ReadGroup(uint64_t *values) {
+  return false;
+}
+#endif
+
+void PerfCounters::Thread::Begin() {
+  counting_ = Open() && ReadGroup(start_);
+}
+
+void PerfCounters::Thread::End(Operation op) {
+  if (!counting_) {
+    return;
+  }
+  counting_ = false;
+  uint64_t now[MAXEVENT];
+  if (!ReadGroup(now)) {
+    return;
+  }
+  const std::vector<Event> &events = parent_->available_;
+  for (size_t i = 0; i < events.size(); i++) {
+    totals_[op][events[i]] += now[i] - start_[i];
+  }
+  counts_[op]++;
+}
+
+void PerfCounters::Sum(uint64_t *counts, uint64_t (*totals)[MAXEVENT]) const {
+  memset(counts, 0, MAXOPTYPE * sizeof(uint64_t));
+  memset(totals, 0, MAXOPTYPE * sizeof(*totals));
+  for (Thread *t : threads_) {
+    for (int op = 0; op < MAXOPTYPE; op++) {
+      counts[op] += t->counts_[op];
+      for (int e = 0; e < MAXEVENT; e++) {
+        totals[op][e] += t->totals_[op][e];
+      }
+    }
+  }
+}
+
+void PerfCounters::Print() {
+  if (available_.empty()) {
+    return;
+  }
+  uint64_t counts[MAXOPTYPE];
+  uint64_t totals[MAXOPTYPE][MAXEVENT];
+  Sum(counts, totals);
+  printf("********** perf counters (per op) **********\n");
+  for (int op = 0; op < MAXOPTYPE; op++) {
+    if (counts[op] == 0) {
+      continue;
+    }
+    printf("%s: count %lu", kOperationString[op], counts[op]);
+    for (Event e : available_) {
+      printf("  %s %.2f", kEventName[e], 1.0 * totals[op][e] / counts[op]);
+    }
+    if (totals[op][CYCLES] > 0 && totals[op][INSTRUCTIONS] > 0) {
+      printf("  IPC %.3f", 1.0 * totals[op][INSTRUCTIONS] / totals[op][CYCLES]);
+    }
+    printf("\n");
+  }
+  printf("********************************************\n");
+}
+
+void PerfCounters::Export(ResultsExporter *exporter, const std::string &phase) {
+  if (available_.empty()) {
+    return;
+  }
+  uint64_t counts[MAXOPTYPE];
+  uint64_t totals[MAXOPTYPE][MAXEVENT];
+  Sum(counts, totals);
+  for (int op = 0; op < MAXOPTYPE; op++) {
+    if (counts[op] == 0) {
+      continue;
+    }
+    std::string prefix = std::string("perf.") + kOperationString[op] + ".";
+    for (Event e : available_) {
+      exporter->AddMetric(phase, prefix + kEventName[e] + "_per_op", 1.0 * totals[op][e] / counts[op]);
+    }
+    if (totals[op][CYCLES] > 0 && totals[op][INSTRUCTIONS] > 0) {
+      exporter->AddMetric(phase, prefix + "ipc", 1.0 * totals[op][INSTRUCTIONS] / totals[op][CYCLES]);
+    }
+  }
+}
+
+void PerfCounters::Reset() {
+  for (Thread *t : threads_) {
+    memset(t->counts_, 0, sizeof(t->counts_));
+    memset(t->totals_, 0, sizeof(t->totals_));
+  }
+}
+
+} // ycsbc
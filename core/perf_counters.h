@@ -0,0 +1,95 @@
+//
+//  perf_counters.h
+//  YCSB-cpp
+//
+
+#ifndef YCSB_C_PERF_COUNTERS_H_
+#define YCSB_C_PERF_COUNTERS_H_
+
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core_workload.h"
+#include "results_exporter.h"
+
+namespace ycsbc {
+
+///
+/// Hardware performance counters (cycles, instructions, LLC misses, branch
+/// misses) of the engine calls, summed per operation type.
+///
+/// Each client thread's DBWrapper reads a perf_event_open group of its own
+/// thread around every DB call, which costs two read() syscalls per call.
+/// Events the kernel or the CPU does not provide (no PMU in a VM,
+/// perf_event_paranoid, ...) are left out; if none is left, counting is
+/// disabled and ForThread() returns nullptr. Kernel time is counted only if
+/// perf_event_paranoid allows it. There are no events on other platforms
+/// than Linux.
+///
+class PerfCounters {
+ public:
+  ///
+  /// The name of the property to enable the counters.
+  ///
+  static const std::string ENABLED_PROPERTY;
+  static const std::string ENABLED_DEFAULT;
+
+  enum Event {
+    CYCLES = 0,
+    INSTRUCTIONS,
+    LLC_MISSES,
+    BRANCH_MISSES,
+    MAXEVENT
+  };
+
+  class Thread {
+   public:
+    Thread(const PerfCounters *parent) : parent_(parent), leader_(-1) {}
+    ~Thread() { Close(); }
+
+    void Begin();
+    void End(Operation op);
+
+   private:
+    friend class PerfCounters;
+
+    bool Open();
+    void Close();
+    bool ReadGroup(uint64_t *values);
+
+    const PerfCounters *parent_;
+    std::thread::id owner_; // counters only count the thread that opened them
+    int leader_;
+    std::vector<int> fds_;
+    bool counting_ = false;
+    uint64_t start_[MAXEVENT];
+    uint64_t counts_[MAXOPTYPE] = {};
+    uint64_t totals_[MAXOPTYPE][MAXEVENT] = {};
+  };
+
+  PerfCounters(int num_threads);
+  ~PerfCounters();
+
+  ///
+  /// The counters of a client thread, nullptr if no event is available.
+  ///
+  Thread *ForThread(int thread_id) { return available_.empty() ? nullptr : threads_[thread_id]; }
+
+  void Print();
+  void Export(ResultsExporter *exporter, const std::string &phase);
+  void Reset();
+
+ private:
+  static int OpenEvent(Event event, bool exclude_kernel, int group_fd);
+  void Sum(uint64_t *counts, uint64_t (*totals)[MAXEVENT]) const;
+
+  std::vector<Event> available_; // in the order of the group
+  bool exclude_kernel_;
+  std::vector<Thread *> threads_;
+};
+
+} // ycsbc
+
+#endif // YCSB_C_PERF_COUNTERS_H_
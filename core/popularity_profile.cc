@@ -0,0 +1,124 @@
+//
+//  popularity_profile.cc
+//  YCSB-cpp
+//
+
+#include "popularity_profile.h"
+
+#include <cstdio>
+
+namespace ycsbc {
+
+const std::string PopularityProfile::ENABLED_PROPERTY = "measurement.rank";
+const std::string PopularityProfile::ENABLED_DEFAULT = "false";
+
+thread_local uint64_t PopularityProfile::rank_ = PopularityProfile::kNoRank;
+
+PopularityProfile::PopularityProfile(utils::Properties *props) : props_(props) {
+  for (auto &bucket : buckets_) {
+    bucket.store(nullptr, std::memory_order_relaxed);
+  }
+}
+
+PopularityProfile::~PopularityProfile() {
+  for (auto &bucket : buckets_) {
+    delete bucket.load();
+  }
+}
+
+int PopularityProfile::Bucket(uint64_t rank) {
+  int bucket = 0;
+  for (uint64_t n = (rank + 1) / 10; n > 0; n /= 10) {
+    bucket++;
+  }
+  return bucket;
+}
+
+std::string PopularityProfile::BucketName(int bucket) {
+  uint64_t lo = 1;
+  for (int i = 0; i < bucket; i++) {
+    lo *= 10;
+  }
+  return std::to_string(lo) + "-" + (bucket + 1 < kMaxBuckets ? std::to_string(lo * 10 - 1) : "");
+}
+
+Measurements *PopularityProfile::GetBucket(int bucket) {
+  Measurements *m = buckets_[bucket].load(std::memory_order_acquire);
+  if (m != nullptr) {
+    return m;
+  }
+  Measurements *created = CreateAuxiliaryMeasurements(props_);
+  if (buckets_[bucket].compare_exchange_strong(m, created, std::memory_order_acq_rel)) {
+    return created;
+  }
+  // another thread was first
+  delete created;
+  return m;
+}
+
+void PopularityProfile::Print() {
+  bool header = false;
+  for (int b = 0; b < kMaxBuckets; b++) {
+    Measurements *m = buckets_[b].load(std::memory_order_acquire);
+    if (m == nullptr) {
+      continue;
+    }
+    for (int i = 0; i < MAXOPTYPE; i++) {
+      Operation op = static_cast<Operation>(i);
+      OpSummary summary;
+      if (!m->Summarize(op, &summary)) {
+        continue;
+      }
+      if (!header) {
+        printf("********** latency by key popularity rank **********\n");
+        header = true;
+      }
+      printf("rank %-24s %-8s count %10lu  avg %9.3f us", BucketName(b).c_str(), kOperationString[op],
+             summary.count, summary.mean / 1000);
+      uint64_t p50, p99, p999;
+      if (summary.Percentile(50, &p50) && summary.Percentile(99, &p99) && summary.Percentile(99.9, &p999)) {
+        printf("  p50 %9.3f us  p99 %9.3f us  p99.9 %9.3f us", p50 / 1000.0, p99 / 1000.0, p999 / 1000.0);
+      }
+      printf("\n");
+    }
+  }
+  if (header) {
+    printf("****************************************************\n");
+  }
+}
+
+void PopularityProfile::Export(ResultsExporter *exporter, const std::string &phase) {
+  for (int b = 0; b < kMaxBuckets; b++) {
+    Measurements *m = buckets_[b].load(std::memory_order_acquire);
+    if (m == nullptr) {
+      continue;
+    }
+    for (int i = 0; i < MAXOPTYPE; i++) {
+      Operation op = static_cast<Operation>(i);
+      OpSummary summary;
+      if (!m->Summarize(op, &summary)) {
+        continue;
+      }
+      std::string prefix = "rank." + BucketName(b) + "." + kOperationString[op];
+      exporter->AddMetric(phase, prefix + ".count", summary.count);
+      exporter->AddMetric(phase, prefix + ".mean", summary.mean);
+      for (double p : {50.0, 99.0, 99.9}) {
+        uint64_t v;
+        if (summary.Percentile(p, &v)) {
+          exporter->AddMetric(phase, prefix + ".p" + (p == 99.9 ? "999" : std::to_string(static_cast<int>(p))), v);
+        }
+      }
+    }
+  }
+}
+
+void PopularityProfile::Reset() {
+  for (auto &bucket : buckets_) {
+    Measurements *m = bucket.load(std::memory_order_acquire);
+    if (m != nullptr) {
+      m->Reset();
+    }
+  }
+}
+
+} // ycsbc
@@ -0,0 +1,79 @@
+//
+//  popularity_profile.h
+//  YCSB-cpp
+//
+
+#ifndef YCSB_C_POPULARITY_PROFILE_H_
+#define YCSB_C_POPULARITY_PROFILE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "measurements.h"
+#include "results_exporter.h"
+#include "utils/properties.h"
+
+namespace ycsbc {
+
+///
+/// Latency per operation type broken down by the popularity rank of the key,
+/// so hits on hot keys and misses on cold keys land in different histograms.
+///
+/// The rank is the zipfian value before ScrambledZipfianGenerator hashes it
+/// to a key number (0 is the most popular). The zipfian draws from far more
+/// values than there are keys, so ranks beyond the record count wrap onto
+/// keys spread over the whole key space. CoreWorkload sets it with
+/// SetRank() when it chooses a transaction key; DBWrapper takes it when it
+/// records the latency of the following DB call. Ranks are bucketed by
+/// decade of rank + 1: [1, 10), [10, 100), ...; the histograms of a bucket
+/// are created when its first latency arrives.
+///
+class PopularityProfile {
+ public:
+  ///
+  /// The name of the property to enable the breakdown.
+  /// Needs requestdistribution=zipfian.
+  ///
+  static const std::string ENABLED_PROPERTY;
+  static const std::string ENABLED_DEFAULT;
+
+  static const uint64_t kNoRank = UINT64_MAX;
+
+  PopularityProfile(utils::Properties *props);
+  ~PopularityProfile();
+
+  static void SetRank(uint64_t rank) { rank_ = rank; }
+
+  ///
+  /// Reports latency under the rank set last by the calling thread, if any.
+  ///
+  void Report(Operation op, uint64_t latency) {
+    if (rank_ == kNoRank) {
+      return;
+    }
+    GetBucket(Bucket(rank_))->Report(op, latency);
+    rank_ = kNoRank;
+  }
+
+  void Print();
+  void Export(ResultsExporter *exporter, const std::string &phase);
+  void Reset();
+
+ private:
+  // decades of rank + 1 up to UINT64_MAX
+  static const int kMaxBuckets = 20;
+
+  static int Bucket(uint64_t rank);
+  static std::string BucketName(int bucket);
+  Measurements *GetBucket(int bucket);
+
+  static thread_local uint64_t rank_;
+
+  utils::Properties *props_;
+  std::atomic<Measurements *> buckets_[kMaxBuckets];
+};
+
+} // ycsbc
+
+#endif // YCSB_C_POPULARITY_PROFILE_H_
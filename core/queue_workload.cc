@@ -0,0 +1,203 @@
+//
+//  queue_workload.cc
+//  YCSB-cpp
+//
+
+#include "queue_workload.h"
+#include "utils/utils.h"
+#include "utils/timer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <map>
+#include <string>
+
+using std::string;
+
+extern std::atomic<uint64_t> ops_cnt[ycsbc::Operation::READMODIFYWRITE + 1];
+extern std::atomic<uint64_t> ops_time[ycsbc::Operation::READMODIFYWRITE + 1];
+
+namespace ycsbc {
+
+const string QueueWorkload::PRODUCER_THREADS_PROPERTY = "queue.producerthreads";
+const string QueueWorkload::PRODUCER_THREADS_DEFAULT = "1";
+
+const string QueueWorkload::MAX_DEPTH_PROPERTY = "queue.maxdepth";
+const string QueueWorkload::MAX_DEPTH_DEFAULT = "0";
+
+thread_local bool QueueWorkload::idle_ = false;
+
+namespace {
+  // keys must sort in sequence order, independent of zeropadding
+  const int kSequenceWidth = 20;
+
+  const char *kDeletesSkipped = "rocksdb.perf.internal_delete_skipped_count";
+  const char *kKeysSkipped = "rocksdb.perf.internal_key_skipped_count";
+} // anonymous
+
+void QueueWorkload::Init(const utils::Properties &p) {
+  CoreWorkload::Init(p);
+
+  producer_threads_ = std::stoi(p.GetProperty(PRODUCER_THREADS_PROPERTY, PRODUCER_THREADS_DEFAULT));
+  max_depth_ = std::stoull(p.GetProperty(MAX_DEPTH_PROPERTY, MAX_DEPTH_DEFAULT));
+  if (producer_threads_ < 0) {
+    throw utils::Exception("queue.producerthreads must not be negative");
+  }
+  head_.store(0);
+  int thread_count = std::stoi(p.GetProperty("threadcount", "1"));
+  producers_running_.store(std::min(producer_threads_, thread_count));
+  consumers_running_.store(thread_count - producers_running_.load());
+}
+
+bool QueueWorkload::Exhausted() const {
+  if (thread_id_ < producer_threads_) {
+    return consumers_running_.load() == 0;
+  }
+  // a producer may have acknowledged a last record after the failed claim
+  return producers_running_.load() == 0 &&
+         head_.load() >= transaction_insert_key_sequence_->Last() + 1;
+}
+
+void QueueWorkload::FinishThread(int thread_id) {
+  if (thread_id < producer_threads_) {
+    producers_running_.fetch_sub(1);
+  } else {
+    consumers_running_.fetch_sub(1);
+  }
+}
+
+std::string QueueWorkload::BuildKeyName(uint64_t key_num) {
+  std::string key = "user";
+  std::string value = std::to_string(key_num);
+  int fill = std::max(0, std::max(zero_padding_, kSequenceWidth) - static_cast<int>(value.size()));
+  return key.append(fill, '0').append(value);
+}
+
+bool QueueWorkload::DoTransaction(DB &db) {
+  DB::Status status;
+  ycsbc::utils::NanoTimer timer;
+  timer.Start();
+  idle_ = false;
+  if (thread_id_ < producer_threads_) {
+    status = Produce(db);
+    if (!idle_) {
+      ops_time[INSERT].fetch_add(timer.End(), std::memory_order_relaxed);
+      ops_cnt[INSERT].fetch_add(1, std::memory_order_relaxed);
+    }
+  } else {
+    // a dequeue is accounted as one scan (seek + delete)
+    status = Consume(db);
+    if (!idle_) {
+      ops_time[SCAN].fetch_add(timer.End(), std::memory_order_relaxed);
+      ops_cnt[SCAN].fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+  return (status == DB::kOK);
+}
+
+DB::Status QueueWorkload::Produce(DB &db) {
+  if (max_depth_ > 0 && Tail() - head_.load(std::memory_order_relaxed) >= max_depth_) {
+    full_.fetch_add(1, std::memory_order_relaxed);
+    idle_ = true;
+    return DB::kNotFound;
+  }
+  return TransactionInsert(db);
+}
+
+bool QueueWorkload::TombstonesSkipped(DB &db, uint64_t *deletes, uint64_t *keys) {
+  std::map<std::string, double> metrics;
+  if (db.GetThreadMetrics(&metrics) != DB::kOK || metrics.count(kDeletesSkipped) == 0) {
+    return false;
+  }
+  *deletes = metrics[kDeletesSkipped];
+  *keys = metrics.count(kKeysSkipped) ? metrics[kKeysSkipped] : 0;
+  return true;
+}
+
+DB::Status QueueWorkload::Consume(DB &db) {
+  uint64_t head = head_.load();
+  do {
+    if (head >= Tail()) {
+      empty_.fetch_add(1, std::memory_order_relaxed);
+      idle_ = true;
+      return DB::kNotFound;
+    }
+  } while (!head_.compare_exchange_weak(head, head + 1));
+
+  const std::string front = BuildKeyName(0);
+  std::vector<std::vector<DB::Field>> result;
+  uint64_t deletes_before, keys_before;
+  bool engine = TombstonesSkipped(db, &deletes_before, &keys_before);
+  ycsbc::utils::Timer<uint64_t, std::micro> timer;
+  timer.Start();
+  DB::Status s;
+  if (!read_all_fields()) {
+    std::vector<std::string> fields;
+    fields.push_back(NextFieldName());
+    s = db.Scan(table_name_, front, 1, &fields, result);
+  } else {
+    s = db.Scan(table_name_, front, 1, NULL, result);
+  }
+  uint64_t latency = timer.End();
+  uint64_t deletes, keys;
+  if (engine && TombstonesSkipped(db, &deletes, &keys)) {
+    engine_seeks_.fetch_add(1, std::memory_order_relaxed);
+    keys_skipped_.fetch_add(keys - keys_before, std::memory_order_relaxed);
+    RecordSeek(deletes - deletes_before, latency);
+  } else {
+    // every record before the claimed one has been consumed and may have left
+    // a tombstone, unless compaction dropped it
+    bounded_seeks_.fetch_add(1, std::memory_order_relaxed);
+    RecordSeek(head, latency);
+  }
+  if (s != DB::kOK) {
+    return s;
+  }
+  return db.Delete(table_name_, BuildKeyName(head));
+}
+
+void QueueWorkload::RecordSeek(uint64_t tombstones, uint64_t latency) {
+  int b = 0;
+  while (b < kSeekBuckets - 1 && (tombstones + 1) >> (b + 1)) {
+    b++;
+  }
+  SeekBucket &bucket = seek_buckets_[b];
+  bucket.count.fetch_add(1, std::memory_order_relaxed);
+  bucket.sum.fetch_add(latency, std::memory_order_relaxed);
+  uint64_t prev = bucket.max.load(std::memory_order_relaxed);
+  while (prev < latency && !bucket.max.compare_exchange_weak(prev, latency, std::memory_order_relaxed)) {
+  }
+}
+
+void QueueWorkload::PrintStats() {
+  uint64_t head = head_.load();
+  uint64_t tail = Tail();
+  printf("********** queue result **********\n");
+  printf("depth: %lu  consumed: %lu  full: %lu  empty: %lu\n",
+         tail > head ? tail - head : 0, head, full_.load(), empty_.load());
+  uint64_t engine_seeks = engine_seeks_.load();
+  uint64_t bounded_seeks = bounded_seeks_.load();
+  if (engine_seeks > 0) {
+    printf("engine-counted seeks: %lu  internal keys skipped: %.1f/seek\n", engine_seeks,
+           1.0 * keys_skipped_.load() / engine_seeks);
+  }
+  if (bounded_seeks > 0) {
+    printf("seeks without engine counters: %lu  (tombstones bounded by the records consumed before)\n",
+           bounded_seeks);
+  }
+  printf("seek latency by tombstones skipped:\n");
+  for (int b = 0; b < kSeekBuckets; b++) {
+    uint64_t cnt = seek_buckets_[b].count.load();
+    if (cnt == 0) {
+      continue;
+    }
+    uint64_t lo = (1ull << b) - 1;
+    uint64_t hi = (b == kSeekBuckets - 1) ? UINT64_MAX : (1ull << (b + 1)) - 2;
+    printf("  [%lu, %lu]: count %lu  avg %.2f us  max %lu us\n", lo, hi, cnt,
+           1.0 * seek_buckets_[b].sum.load() / cnt, seek_buckets_[b].max.load());
+  }
+  printf("**********************************\n");
+}
+
+} // ycsbc
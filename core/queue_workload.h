@@ -0,0 +1,96 @@
+//
+//  queue_workload.h
+//  YCSB-cpp
+//
+
+#ifndef YCSB_C_QUEUE_WORKLOAD_H_
+#define YCSB_C_QUEUE_WORKLOAD_H_
+
+#include <atomic>
+#include <string>
+#include "core_workload.h"
+#include "utils/properties.h"
+
+namespace ycsbc {
+
+///
+/// FIFO queue workload.
+/// Keys are sequence numbers in key order. The first queue.producerthreads
+/// client threads append at the tail; the remaining threads consume from the
+/// head: they seek to the oldest key ever enqueued (a one-record scan that has
+/// to skip every tombstone left by earlier consumers) and delete the claimed
+/// record. Seek latency is reported against the number of tombstones the seek
+/// skipped, as counted by the engine (DB::GetThreadMetrics()) where available
+/// and otherwise bounded by the number of records consumed before.
+///
+/// Only completed enqueues and dequeues are operations; attempts on a full or
+/// empty queue are counted separately and retried. A consumer stops once the
+/// queue is empty and every producer has finished, a producer once the queue
+/// is full and every consumer has finished.
+///
+class QueueWorkload : public CoreWorkload {
+ public:
+  ///
+  /// The name of the property for the number of producer threads.
+  /// All other client threads consume.
+  ///
+  static const std::string PRODUCER_THREADS_PROPERTY;
+  static const std::string PRODUCER_THREADS_DEFAULT;
+
+  ///
+  /// The name of the property for the maximum queue depth.
+  /// Producers do not enqueue while the queue is full. 0 means unbounded.
+  /// The initial depth is the number of loaded records.
+  ///
+  static const std::string MAX_DEPTH_PROPERTY;
+  static const std::string MAX_DEPTH_DEFAULT;
+
+  void Init(const utils::Properties &p) override;
+  bool DoTransaction(DB &db) override;
+  bool NextAccessKeyNum(uint64_t *key_num) override { return false; }
+  bool LastTransactionIdle() const override { return idle_; }
+  bool Exhausted() const override;
+  void FinishThread(int thread_id) override;
+  void PrintStats() override;
+
+  QueueWorkload() : producer_threads_(0), max_depth_(0), head_(0), producers_running_(0),
+                    consumers_running_(0), full_(0), empty_(0), engine_seeks_(0),
+                    bounded_seeks_(0), keys_skipped_(0) {
+  }
+
+ protected:
+  std::string BuildKeyName(uint64_t key_num) override;
+
+  DB::Status Produce(DB &db);
+  DB::Status Consume(DB &db);
+  static bool TombstonesSkipped(DB &db, uint64_t *deletes, uint64_t *keys);
+
+  // exclusive end of the acknowledged part of the queue
+  uint64_t Tail() { return transaction_insert_key_sequence_->Last() + 1; }
+
+  // seek latency by floor(log2(tombstones + 1))
+  static const int kSeekBuckets = 64;
+  struct SeekBucket {
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> sum{0};
+    std::atomic<uint64_t> max{0};
+  };
+  void RecordSeek(uint64_t tombstones, uint64_t latency);
+
+  int producer_threads_;
+  uint64_t max_depth_;
+  std::atomic<uint64_t> head_; // next key to be consumed
+  std::atomic<int> producers_running_;
+  std::atomic<int> consumers_running_;
+  std::atomic<uint64_t> full_;
+  std::atomic<uint64_t> empty_;
+  std::atomic<uint64_t> engine_seeks_;  // with tombstones counted by the engine
+  std::atomic<uint64_t> bounded_seeks_; // with the client-side bound
+  std::atomic<uint64_t> keys_skipped_;  // internal keys, by the engine
+  static thread_local bool idle_;
+  SeekBucket seek_buckets_[kSeekBuckets];
+};
+
+} // ycsbc
+
+#endif // YCSB_C_QUEUE_WORKLOAD_H_
@@ -0,0 +1,302 @@
+//
+//  resource_monitor.cc
+//  YCSB-cpp
+//
+
+#include "resource_monitor.h"
+#include "utils/utils.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#ifdef __linux__
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+#include <unistd.h>
+#endif
+
+namespace ycsbc {
+
+namespace {
+  // /proc/diskstats counts 512-byte sectors regardless of the device
+  const uint64_t kSectorSize = 512;
+
+#ifdef __linux__
+  double Seconds(const timeval &tv) {
+    return tv.tv_sec + tv.tv_usec * 1e-6;
+  }
+#endif
+} // anonymous
+
+ResourceMonitor::ResourceMonitor(const std::string &dbpath)
+    : disk_major_(-1), disk_minor_(-1), last_ops_(0), interval_ops_(0) {
+#ifdef __linux__
+  // the db directory may not exist yet; its closest existing ancestor is on the same device
+  if (!dbpath.empty()) {
+    std::filesystem::path path = std::filesystem::absolute(dbpath);
+    struct stat st;
+    while (stat(path.c_str(), &st) != 0 && path.has_parent_path() && path != path.parent_path()) {
+      path = path.parent_path();
+    }
+    if (stat(path.c_str(), &st) == 0) {
+      std::ifstream diskstats("/proc/diskstats");
+      std::string line;
+      while (std::getline(diskstats, line)) {
+        std::istringstream fields(line);
+        long major, minor;
+        std::string name;
+        if (fields >> major >> minor >> name && major == static_cast<long>(major(st.st_dev)) &&
+            minor == static_cast<long>(minor(st.st_dev))) {
+          disk_major_ = major;
+          disk_minor_ = minor;
+          disk_name_ = name;
+          break;
+        }
+      }
+    }
+  }
+#endif
+  StartPhase();
+}
+
+bool ResourceMonitor::ReadProcStatus(Sample *sample) {
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  uint64_t rss_kb = 0, hwm_kb = 0;
+  int found = 0;
+  while (std::getline(status, line)) {
+    std::istringstream fields(line);
+    std::string key;
+    uint64_t value;
+    if (!(fields >> key >> value)) {
+      continue;
+    }
+    if (key == "VmRSS:") {
+      rss_kb = value;
+      found++;
+    } else if (key == "VmHWM:") {
+      hwm_kb = value;
+      found++;
+    }
+  }
+  if (found != 2) {
+    return false;
+  }
+  sample->rss_bytes = rss_kb * 1024;
+  sample->max_rss_bytes = hwm_kb * 1024;
+  return true;
+}
+
+bool ResourceMonitor::ReadProcIo(Sample *sample) {
+  std::ifstream io("/proc/self/io");
+  std::string key;
+  uint64_t value;
+  int found = 0;
+  while (io >> key >> value) {
+    if (key == "read_bytes:") {
+      sample->read_bytes = value;
+      found++;
+    } else if (key == "write_bytes:") {
+      sample->write_bytes = value;
+      found++;
+    }
+  }
+  return found == 2;
+}
+
+bool ResourceMonitor::ReadDiskStats(Sample *sample) {
+  if (disk_major_ < 0) {
+    return false;
+  }
+  std::ifstream diskstats("/proc/diskstats");
+  std::string line;
+  while (std::getline(diskstats, line)) {
+    std::istringstream fields(line);
+    long major, minor;
+    std::string name;
+    uint64_t reads, reads_merged, sectors_read, read_ms;
+    uint64_t writes, writes_merged, sectors_written, write_ms, in_flight, io_ms;
+    if (!(fields >> major >> minor >> name) || major != disk_major_ || minor != disk_minor_) {
+      continue;
+    }
+    if (!(fields >> reads >> reads_merged >> sectors_read >> read_ms >> writes >> writes_merged
+                 >> sectors_written >> write_ms >> in_flight >> io_ms)) {
+      return false;
+    }
+    sample->disk_read_bytes = sectors_read * kSectorSize;
+    sample->disk_write_bytes = sectors_written * kSectorSize;
+    sample->disk_io_ms = io_ms;
+    return true;
+  }
+  return false;
+}
+
+ResourceMonitor::Sample ResourceMonitor::Take() {
+  Sample sample = {};
+  sample.wall_sec = std::chrono::duration<double>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+
+#ifdef __linux__
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0) {
+    sample.has_usage = true;
+    sample.user_sec = Seconds(usage.ru_utime);
+    sample.sys_sec = Seconds(usage.ru_stime);
+    sample.max_rss_bytes = static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+    sample.voluntary_switches = usage.ru_nvcsw;
+    sample.involuntary_switches = usage.ru_nivcsw;
+  }
+
+  // current and peak from the same source, ru_maxrss and statm are not consistent
+  if (!ReadProcStatus(&sample)) {
+    std::ifstream statm("/proc/self/statm");
+    uint64_t size, resident;
+    if (statm >> size >> resident) {
+      sample.rss_bytes = resident * sysconf(_SC_PAGESIZE);
+    }
+  }
+  sample.max_rss_bytes = std::max(sample.max_rss_bytes, sample.rss_bytes);
+
+  sample.has_io = ReadProcIo(&sample);
+  sample.has_disk = ReadDiskStats(&sample);
+#endif
+  return sample;
+}
+
+void ResourceMonitor::StartPhase() {
+  phase_start_ = Take();
+  phase_end_ = phase_start_;
+  last_ = phase_start_;
+  current_ = phase_start_;
+  last_ops_ = 0;
+  interval_ops_ = 0;
+}
+
+void ResourceMonitor::FinishPhase() {
+  phase_end_ = Take();
+}
+
+void ResourceMonitor::FinishInterval(uint64_t ops) {
+  last_ = current_;
+  current_ = Take();
+  interval_ops_ = ops - std::min(ops, last_ops_);
+  last_ops_ = ops;
+}
+
+std::string ResourceMonitor::GetIntervalStatusMsg() {
+  double sec = current_.wall_sec - last_.wall_sec;
+  if (sec <= 0 || !current_.has_usage) {
+    return "";
+  }
+  double user = current_.user_sec - last_.user_sec;
+  double sys = current_.sys_sec - last_.sys_sec;
+  std::ostringstream msg_stream;
+  msg_stream.precision(2);
+  msg_stream << std::fixed << " [RESOURCES: CPU=" << (user + sys) / sec << " cores"
+             << " (usr=" << user / sec << " sys=" << sys / sec << ")"
+             << " RSS=" << current_.rss_bytes / utils::kMB << " MB"
+             << " CTXSW=" << (current_.voluntary_switches - last_.voluntary_switches) / sec
+             << "/" << (current_.involuntary_switches - last_.involuntary_switches) / sec
+             << " vol/invol per sec";
+  if (current_.has_io && last_.has_io) {
+    msg_stream << " IO read=" << (current_.read_bytes - last_.read_bytes) / utils::kMB / sec
+               << " write=" << (current_.write_bytes - last_.write_bytes) / utils::kMB / sec << " MB/s";
+  }
+  if (current_.has_disk && last_.has_disk) {
+    msg_stream << " DISK(" << disk_name_ << ") read="
+               << (current_.disk_read_bytes - last_.disk_read_bytes) / utils::kMB / sec
+               << " write=" << (current_.disk_write_bytes - last_.disk_write_bytes) / utils::kMB / sec
+               << " MB/s util=" << (current_.disk_io_ms - last_.disk_io_ms) / (10 * sec) << "%";
+  }
+  if (user + sys > 0) {
+    msg_stream << " OPS/CPU-SEC=" << interval_ops_ / (user + sys);
+  }
+  msg_stream << "]";
+  return msg_stream.str();
+}
+
+void ResourceMonitor::AddIntervalMetrics(std::map<std::string, double> *metrics) {
+  double sec = current_.wall_sec - last_.wall_sec;
+  if (sec <= 0 || !current_.has_usage) {
+    return;
+  }
+  double cpu = current_.user_sec - last_.user_sec + current_.sys_sec - last_.sys_sec;
+  (*metrics)["resource.cpu_cores"] = cpu / sec;
+  (*metrics)["resource.rss_bytes"] = current_.rss_bytes;
+  (*metrics)["resource.ops_per_cpu_sec"] = cpu > 0 ? interval_ops_ / cpu : 0;
+  if (current_.has_io && last_.has_io) {
+    (*metrics)["resource.io_read_bytes_per_sec"] = (current_.read_bytes - last_.read_bytes) / sec;
+    (*metrics)["resource.io_write_bytes_per_sec"] = (current_.write_bytes - last_.write_bytes) / sec;
+  }
+  if (current_.has_disk && last_.has_disk) {
+    (*metrics)["resource.disk_read_bytes_per_sec"] = (current_.disk_read_bytes - last_.disk_read_bytes) / sec;
+    (*metrics)["resource.disk_write_bytes_per_sec"] = (current_.disk_write_bytes - last_.disk_write_bytes) / sec;
+    (*metrics)["resource.disk_util_pct"] = (current_.disk_io_ms - last_.disk_io_ms) / (10 * sec);
+  }
+}
+
+void ResourceMonitor::Print(uint64_t ops) {
+  const Sample &end = phase_end_;
+  if (!end.has_usage) {
+    printf("resource usage: not sampled on this platform\n");
+    return;
+  }
+  double sec = end.wall_sec - phase_start_.wall_sec;
+  double user = end.user_sec - phase_start_.user_sec;
+  double sys = end.sys_sec - phase_start_.sys_sec;
+  printf("********** resource usage **********\n");
+  printf("cpu: user %.3f s  sys %.3f s  avg %.2f cores\n", user, sys, sec > 0 ? (user + sys) / sec : 0);
+  printf("ops per cpu-second: %.2f\n", user + sys > 0 ? ops / (user + sys) : 0);
+  printf("rss: %.2f MB  peak %.2f MB\n", end.rss_bytes / utils::kMB, end.max_rss_bytes / utils::kMB);
+  printf("context switches: voluntary %lu  involuntary %lu\n",
+         end.voluntary_switches - phase_start_.voluntary_switches,
+         end.involuntary_switches - phase_start_.involuntary_switches);
+  if (end.has_io && phase_start_.has_io) {
+    printf("process io: read %.2f MB  write %.2f MB\n", (end.read_bytes - phase_start_.read_bytes) / utils::kMB,
+           (end.write_bytes - phase_start_.write_bytes) / utils::kMB);
+  }
+  if (end.has_disk && phase_start_.has_disk) {
+    printf("disk %s: read %.2f MB  write %.2f MB  util %.2f%%\n", disk_name_.c_str(),
+           (end.disk_read_bytes - phase_start_.disk_read_bytes) / utils::kMB,
+           (end.disk_write_bytes - phase_start_.disk_write_bytes) / utils::kMB,
+           sec > 0 ? (end.disk_io_ms - phase_start_.disk_io_ms) / (10 * sec) : 0);
+  }
+  printf("************************************\n");
+}
+
+void ResourceMonitor::Export(ResultsExporter *exporter, const std::string &phase, uint64_t ops) {
+  const Sample &end = phase_end_;
+  if (!end.has_usage) {
+    return;
+  }
+  double sec = end.wall_sec - phase_start_.wall_sec;
+  double user = end.user_sec - phase_start_.user_sec;
+  double sys = end.sys_sec - phase_start_.sys_sec;
+  exporter->AddMetric(phase, "resource.cpu_user_sec", user);
+  exporter->AddMetric(phase, "resource.cpu_sys_sec", sys);
+  exporter->AddMetric(phase, "resource.cpu_cores", sec > 0 ? (user + sys) / sec : 0);
+  exporter->AddMetric(phase, "resource.ops_per_cpu_sec", user + sys > 0 ? ops / (user + sys) : 0);
+  exporter->AddMetric(phase, "resource.rss_bytes", end.rss_bytes);
+  exporter->AddMetric(phase, "resource.max_rss_bytes", end.max_rss_bytes);
+  exporter->AddMetric(phase, "resource.voluntary_switches",
+                      end.voluntary_switches - phase_start_.voluntary_switches);
+  exporter->AddMetric(phase, "resource.involuntary_switches",
+                      end.involuntary_switches - phase_start_.involuntary_switches);
+  if (end.has_io && phase_start_.has_io) {
+    exporter->AddMetric(phase, "resource.io_read_bytes", end.read_bytes - phase_start_.read_bytes);
+    exporter->AddMetric(phase, "resource.io_write_bytes", end.write_bytes - phase_start_.write_bytes);
+  }
+  if (end.has_disk && phase_start_.has_disk) {
+    exporter->AddMetric(phase, "resource.disk_read_bytes", end.disk_read_bytes - phase_start_.disk_read_bytes);
+    exporter->AddMetric(phase, "resource.disk_write_bytes", end.disk_write_bytes - phase_start_.disk_write_bytes);
+    exporter->AddMetric(phase, "resource.disk_util_pct",
+                        sec > 0 ? (end.disk_io_ms - phase_start_.disk_io_ms) / (10 * sec) : 0);
+  }
+}
+
+} // ycsbc
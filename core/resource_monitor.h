@@ -0,0 +1,97 @@
+//
+//  resource_monitor.h
+//  YCSB-cpp
+//
+
+#ifndef YCSB_C_RESOURCE_MONITOR_H_
+#define YCSB_C_RESOURCE_MONITOR_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+#include "results_exporter.h"
+
+namespace ycsbc {
+
+///
+/// Samples the resource usage of the process: CPU time and context switches
+/// (getrusage), current and peak resident set size (VmRSS and VmHWM of
+/// /proc/self/status), storage I/O (/proc/self/io) and, if dbpath is on a
+/// block device listed in /proc/diskstats, the I/O of that device. Sources
+/// that are not available are left out; nothing is sampled except on Linux.
+///
+class ResourceMonitor {
+ public:
+  ResourceMonitor(const std::string &dbpath);
+
+  ///
+  /// Takes the baseline of a phase.
+  ///
+  void StartPhase();
+
+  ///
+  /// Samples and closes the current interval. ops is the number of operations
+  /// done since StartPhase().
+  ///
+  void FinishInterval(uint64_t ops);
+  std::string GetIntervalStatusMsg();
+
+  ///
+  /// Adds the rates of the last finished interval as resource.* metrics,
+  /// e.g. for a sample of the exported time series.
+  ///
+  void AddIntervalMetrics(std::map<std::string, double> *metrics);
+
+  ///
+  /// Takes the end sample of a phase, right after its client threads finished.
+  ///
+  void FinishPhase();
+
+  ///
+  /// Prints the usage between StartPhase() and FinishPhase() given the
+  /// operations done in it.
+  ///
+  void Print(uint64_t ops);
+  void Export(ResultsExporter *exporter, const std::string &phase, uint64_t ops);
+
+ private:
+  struct Sample {
+    double wall_sec;
+    double user_sec;
+    double sys_sec;
+    bool has_usage;
+    uint64_t max_rss_bytes;
+    uint64_t rss_bytes;
+    uint64_t voluntary_switches;
+    uint64_t involuntary_switches;
+    bool has_io;
+    uint64_t read_bytes;
+    uint64_t write_bytes;
+    bool has_disk;
+    uint64_t disk_read_bytes;
+    uint64_t disk_write_bytes;
+    uint64_t disk_io_ms;
+  };
+
+  Sample Take();
+  bool ReadProcStatus(Sample *sample);
+  bool ReadProcIo(Sample *sample);
+  bool ReadDiskStats(Sample *sample);
+
+  // major/minor of the device backing dbpath, -1 if unknown
+  long disk_major_;
+  long disk_minor_;
+  std::string disk_name_;
+
+  Sample phase_start_;
+  Sample phase_end_;
+  Sample last_;
+  Sample current_;
+  uint64_t last_ops_;
+  uint64_t interval_ops_;
+};
+
+} // ycsbc
+
+#endif // YCSB_C_RESOURCE_MONITOR_H_
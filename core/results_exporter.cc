@@ -0,0 +1,269 @@
+//
+//  results_exporter.cc
+//  YCSB-cpp
+//
+
+#include "results_exporter.h"
+#include "core_workload.h"
+#include "utils/utils.h"
+
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/utsname.h>
+#include <unistd.h>
+#define YCSB_C_HAVE_UNAME
+#endif
+
+namespace ycsbc {
+
+namespace {
+  std::string JsonString(const std::string &str) {
+    std::ostringstream out;
+    out << '"';
+    for (char c : str) {
+      switch (c) {
+        case '"': out << "\\\""; break;
+        case '\\': out << "\\\\"; break;
+        case '\n': out << "\\n"; break;
+        case '\r': out << "\\r"; break;
+        case '\t': out << "\\t"; break;
+        default:
+          if (static_cast<unsigned char>(c) < 0x20) {
+            out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c);
+          } else {
+            out << c;
+          }
+      }
+    }
+    out << '"';
+    return out.str();
+  }
+
+  std::string CsvField(const std::string &str) {
+    if (str.find_first_of(",\"\n\r") == std::string::npos) {
+      return str;
+    }
+    std::string quoted = "\"";
+    for (char c : str) {
+      if (c == '"') {
+        quoted += '"';
+      }
+      quoted += c;
+    }
+    return quoted + "\"";
+  }
+
+  std::string Number(double value) {
+    if (!std::isfinite(value)) {
+      return "null";
+    }
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(6) << value;
+    return out.str();
+  }
+
+  std::string PercentileKey(double p) {
+    std::ostringstream out;
+    out << p;
+    return out.str();
+  }
+} // anonymous
+
+ResultsExporter::ResultsExporter(const utils::Properties &props)
+    : properties_(props.GetProperties()) {
+  std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+  std::ostringstream timestamp;
+  timestamp << std::put_time(std::localtime(&now), "%FT%T%z");
+  info_.emplace_back("timestamp", timestamp.str());
+  info_.emplace_back("engine", props.GetProperty("dbname", "basic"));
+  info_.emplace_back("threads", props.GetProperty("threadcount", "1"));
+  info_.emplace_back("workload", props.GetProperty(CoreWorkload::WORKLOAD_PROPERTY,
+                                                   CoreWorkload::WORKLOAD_DEFAULT));
+  info_.emplace_back("latency_unit", "ns");
+
+  // elsewhere only the portable part of the host description is recorded
+  std::string os;
+#ifdef YCSB_C_HAVE_UNAME
+  char hostname[256] = {0};
+  if (gethostname(hostname, sizeof(hostname) - 1) == 0) {
+    info_.emplace_back("hostname", hostname);
+  }
+  struct utsname uts;
+  if (uname(&uts) == 0) {
+    os = std::string(uts.sysname) + " " + uts.release;
+    info_.emplace_back("machine", uts.machine);
+  }
+#endif
+  info_.emplace_back("os", os);
+  long cpus = 0;
+#if defined(YCSB_C_HAVE_UNAME) && defined(_SC_NPROCESSORS_ONLN)
+  cpus = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+  if (cpus <= 0) {
+    cpus = std::thread::hardware_concurrency();
+  }
+  info_.emplace_back("cpus", std::to_string(cpus));
+#if defined(YCSB_C_HAVE_UNAME) && defined(_SC_PHYS_PAGES)
+  long pages = sysconf(_SC_PHYS_PAGES);
+  long page_size = sysconf(_SC_PAGE_SIZE);
+  if (pages > 0 && page_size > 0) {
+    info_.emplace_back("memory_bytes", std::to_string(static_cast<uint64_t>(pages) * page_size));
+  }
+#endif
+}
+
+ResultsExporter::PhaseResult &ResultsExporter::GetPhase(const std::string &phase) {
+  for (PhaseResult &result : phases_) {
+    if (result.name == phase) {
+      return result;
+    }
+  }
+  phases_.push_back(PhaseResult{phase, 0, 0, {}, {}, {}});
+  return phases_.back();
+}
+
+void ResultsExporter::AddPhase(const std::string &phase, double runtime_sec, uint64_t operations,
+                               Measurements *measurements) {
+  PhaseResult &result = GetPhase(phase);
+  result.runtime_sec = runtime_sec;
+  result.operations = operations;
+  result.ops.clear();
+  for (int i = 0; i < MAXOPTYPE; i++) {
+    Operation op = static_cast<Operation>(i);
+    OpSummary summary;
+    if (!measurements->Summarize(op, &summary)) {
+      continue;
+    }
+    double throughput = runtime_sec > 0 ? summary.count / runtime_sec : 0;
+    result.ops.push_back(OpResult{kOperationString[op], throughput, summary});
+  }
+}
+
+void ResultsExporter::AddMetric(const std::string &phase, const std::string &name, double value) {
+  GetPhase(phase).metrics.emplace_back(name, value);
+}
+
+void ResultsExporter::AddSample(const std::string &phase, double elapsed_sec,
+                                const std::map<std::string, double> &values) {
+  GetPhase(phase).timeseries.push_back(Sample{elapsed_sec, values});
+}
+
+void ResultsExporter::Write(const std::string &path) const {
+  std::ofstream out(path);
+  if (!out.is_open()) {
+    throw utils::Exception("failed to open: " + path);
+  }
+  if (path.size() >= 4 && path.compare(path.size() - 4, 4, ".csv") == 0) {
+    WriteCsv(out);
+  } else {
+    WriteJson(out);
+  }
+  if (!out.good()) {
+    throw utils::Exception("failed to write: " + path);
+  }
+}
+
+void ResultsExporter::WriteJson(std::ostream &out) const {
+  out << "{\n  \"info\": {";
+  for (size_t i = 0; i < info_.size(); i++) {
+    out << (i ? "," : "") << "\n    " << JsonString(info_[i].first) << ": "
+        << JsonString(info_[i].second);
+  }
+  out << "\n  },\n  \"properties\": {";
+  bool first = true;
+  for (auto &prop : properties_) {
+    out << (first ? "" : ",") << "\n    " << JsonString(prop.first) << ": " << JsonString(prop.second);
+    first = false;
+  }
+  out << "\n  },\n  \"phases\": [";
+  for (size_t i = 0; i < phases_.size(); i++) {
+    const PhaseResult &phase = phases_[i];
+    double throughput = phase.runtime_sec > 0 ? phase.operations / phase.runtime_sec : 0;
+    out << (i ? "," : "") << "\n    {\n"
+        << "      \"phase\": " << JsonString(phase.name) << ",\n"
+        << "      \"runtime_sec\": " << Number(phase.runtime_sec) << ",\n"
+        << "      \"operations\": " << phase.operations << ",\n"
+        << "      \"throughput\": " << Number(throughput) << ",\n"
+        << "      \"ops\": {";
+    for (size_t j = 0; j < phase.ops.size(); j++) {
+      const OpResult &op = phase.ops[j];
+      out << (j ? "," : "") << "\n        " << JsonString(op.name) << ": {"
+          << "\"count\": " << op.summary.count
+          << ", \"throughput\": " << Number(op.throughput)
+          << ", \"mean\": " << Number(op.summary.mean)
+          << ", \"min\": " << op.summary.min
+          << ", \"max\": " << op.summary.max
+          << ", \"percentiles\": {";
+      for (size_t k = 0; k < op.summary.percentiles.size(); k++) {
+        out << (k ? ", " : "") << JsonString(PercentileKey(op.summary.percentiles[k].first))
+            << ": " << op.summary.percentiles[k].second;
+      }
+      out << "}}";
+    }
+    out << "\n      },\n      \"metrics\": {";
+    for (size_t j = 0; j < phase.metrics.size(); j++) {
+      out << (j ? "," : "") << "\n        " << JsonString(phase.metrics[j].first) << ": "
+          << Number(phase.metrics[j].second);
+    }
+    out << "\n      },\n      \"timeseries\": [";
+    for (size_t j = 0; j < phase.timeseries.size(); j++) {
+      const Sample &sample = phase.timeseries[j];
+      out << (j ? "," : "") << "\n        {\"elapsed_sec\": " << Number(sample.elapsed_sec)
+          << ", \"values\": {";
+      bool first_value = true;
+      for (auto &value : sample.values) {
+        out << (first_value ? "" : ", ") << JsonString(value.first) << ": " << Number(value.second);
+        first_value = false;
+      }
+      out << "}}";
+    }
+    out << "\n      ]\n    }";
+  }
+  out << "\n  ]\n}\n";
+}
+
+void ResultsExporter::WriteCsv(std::ostream &out) const {
+  out << "phase,item,metric,value\n";
+  for (auto &item : info_) {
+    out << ",info," << CsvField(item.first) << "," << CsvField(item.second) << "\n";
+  }
+  for (auto &prop : properties_) {
+    out << ",property," << CsvField(prop.first) << "," << CsvField(prop.second) << "\n";
+  }
+  for (const PhaseResult &phase : phases_) {
+    std::string name = CsvField(phase.name);
+    double throughput = phase.runtime_sec > 0 ? phase.operations / phase.runtime_sec : 0;
+    out << name << ",phase,runtime_sec," << Number(phase.runtime_sec) << "\n"
+        << name << ",phase,operations," << phase.operations << "\n"
+        << name << ",phase,throughput," << Number(throughput) << "\n";
+    for (const OpResult &op : phase.ops) {
+      out << name << "," << op.name << ",count," << op.summary.count << "\n"
+          << name << "," << op.name << ",throughput," << Number(op.throughput) << "\n"
+          << name << "," << op.name << ",mean," << Number(op.summary.mean) << "\n"
+          << name << "," << op.name << ",min," << op.summary.min << "\n"
+          << name << "," << op.name << ",max," << op.summary.max << "\n";
+      for (auto &p : op.summary.percentiles) {
+        out << name << "," << op.name << "," << "p" << PercentileKey(p.first) << "," << p.second << "\n";
+      }
+    }
+    for (auto &metric : phase.metrics) {
+      out << name << ",metric," << CsvField(metric.first) << "," << Number(metric.second) << "\n";
+    }
+    // one item per sample, "series@<elapsed_sec>"
+    for (const Sample &sample : phase.timeseries) {
+      std::string item = "series@" + Number(sample.elapsed_sec);
+      for (auto &value : sample.values) {
+        out << name << "," << item << "," << CsvField(value.first) << "," << Number(value.second) << "\n";
+      }
+    }
+  }
+}
+
+} // ycsbc
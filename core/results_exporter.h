@@ -0,0 +1,84 @@
+//
+//  results_exporter.h
+//  YCSB-cpp
+//
+
+#ifndef YCSB_C_RESULTS_EXPORTER_H_
+#define YCSB_C_RESULTS_EXPORTER_H_
+
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "measurements.h"
+#include "utils/properties.h"
+
+namespace ycsbc {
+
+///
+/// Collects the results of one benchmark invocation and writes them as a
+/// single artifact: a JSON document, or CSV rows of (phase,item,metric,value)
+/// if the path ends with ".csv".
+///
+class ResultsExporter {
+ public:
+  ResultsExporter(const utils::Properties &props);
+
+  ///
+  /// Records the summary of a finished phase ("load" or "run").
+  /// Must be called before the measurements are reset.
+  ///
+  void AddPhase(const std::string &phase, double runtime_sec, uint64_t operations,
+                Measurements *measurements);
+
+  ///
+  /// Attaches a named value to a phase.
+  ///
+  void AddMetric(const std::string &phase, const std::string &name, double value);
+
+  ///
+  /// Appends a sample of a time series to a phase, taken elapsed_sec after
+  /// the phase started.
+  ///
+  void AddSample(const std::string &phase, double elapsed_sec,
+                 const std::map<std::string, double> &values);
+
+  ///
+  /// Writes everything collected so far to path.
+  ///
+  void Write(const std::string &path) const;
+
+ private:
+  struct OpResult {
+    std::string name;
+    double throughput;
+    OpSummary summary;
+  };
+  struct Sample {
+    double elapsed_sec;
+    std::map<std::string, double> values;
+  };
+  struct PhaseResult {
+    std::string name;
+    double runtime_sec;
+    uint64_t operations;
+    std::vector<OpResult> ops;
+    std::vector<std::pair<std::string, double>> metrics;
+    std::vector<Sample> timeseries;
+  };
+
+  PhaseResult &GetPhase(const std::string &phase);
+  void WriteJson(std::ostream &out) const;
+  void WriteCsv(std::ostream &out) const;
+
+  std::vector<std::pair<std::string, std::string>> info_;
+  std::map<std::string, std::string> properties_;
+  std::vector<PhaseResult> phases_;
+};
+
+} // ycsbc
+
+#endif // YCSB_C_RESULTS_EXPORTER_H_
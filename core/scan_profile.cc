@@ -0,0 +1,97 @@
+//
+//  scan_profile.cc
+//  YCSB-cpp
+//
+
+#include "scan_profile.h"
+#include "utils/utils.h"
+
+#include <cstdio>
+
+namespace ycsbc {
+
+const std::string ScanProfile::ENABLED_PROPERTY = "measurement.scan";
+const std::string ScanProfile::ENABLED_DEFAULT = "false";
+
+ScanProfile *ScanProfile::active_ = nullptr;
+
+namespace {
+  const char *kStageName[ScanProfile::MAXSTAGE] = {"create", "seek", "next"};
+} // anonymous
+
+ScanProfile::ScanProfile(utils::Properties *props) {
+  if (active_ != nullptr) {
+    throw utils::Exception("only one scan profile may exist");
+  }
+  for (int i = 0; i < MAXSTAGE; i++) {
+    stages_[i] = CreateAuxiliaryMeasurements(props);
+  }
+  active_ = this;
+}
+
+ScanProfile::~ScanProfile() {
+  active_ = nullptr;
+  for (int i = 0; i < MAXSTAGE; i++) {
+    delete stages_[i];
+  }
+}
+
+void ScanProfile::Print() {
+  OpSummary summary[MAXSTAGE];
+  bool any = false;
+  for (int i = 0; i < MAXSTAGE; i++) {
+    if (stages_[i]->Summarize(SCAN, &summary[i])) {
+      any = true;
+    } else {
+      summary[i].count = 0;
+    }
+  }
+  if (!any) {
+    return;
+  }
+  printf("********** scan breakdown **********\n");
+  for (int i = 0; i < MAXSTAGE; i++) {
+    if (summary[i].count == 0) {
+      continue;
+    }
+    printf("%-7s count %10lu  avg %9.3f us", kStageName[i], summary[i].count, summary[i].mean / 1000);
+    uint64_t p50, p99;
+    if (summary[i].Percentile(50, &p50) && summary[i].Percentile(99, &p99)) {
+      printf("  p50 %9.3f us  p99 %9.3f us", p50 / 1000.0, p99 / 1000.0);
+    }
+    if (i == NEXT && summary[i].mean > 0) {
+      printf("  %.0f records/sec per iterator", 1e9 / summary[i].mean);
+    }
+    printf("\n");
+  }
+  if (summary[SEEK].count > 0 && summary[NEXT].count > 0) {
+    printf("nexts per seek: %.1f\n", 1.0 * summary[NEXT].count / summary[SEEK].count);
+  }
+  printf("************************************\n");
+}
+
+void ScanProfile::Export(ResultsExporter *exporter, const std::string &phase) {
+  for (int i = 0; i < MAXSTAGE; i++) {
+    OpSummary summary;
+    if (!stages_[i]->Summarize(SCAN, &summary)) {
+      continue;
+    }
+    std::string prefix = std::string("scan.") + kStageName[i];
+    exporter->AddMetric(phase, prefix + ".count", summary.count);
+    exporter->AddMetric(phase, prefix + ".mean", summary.mean);
+    for (double p : {50.0, 99.0}) {
+      uint64_t v;
+      if (summary.Percentile(p, &v)) {
+        exporter->AddMetric(phase, prefix + ".p" + std::to_string(static_cast<int>(p)), v);
+      }
+    }
+  }
+}
+
+void ScanProfile::Reset() {
+  for (int i = 0; i < MAXSTAGE; i++) {
+    stages_[i]->Reset();
+  }
+}
+
+} // ycsbc
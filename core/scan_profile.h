@@ -0,0 +1,82 @@
+//
+//  scan_profile.h
+//  YCSB-cpp
+//
+
+#ifndef YCSB_C_SCAN_PROFILE_H_
+#define YCSB_C_SCAN_PROFILE_H_
+
+#include <cstdint>
+#include <string>
+
+#include "measurements.h"
+#include "results_exporter.h"
+#include "utils/properties.h"
+#include "utils/timer.h"
+
+namespace ycsbc {
+
+///
+/// Splits the engine time of scans into iterator creation, the seek to the
+/// start key and every single step to the next record, each kept as a
+/// histogram, so scans of different lengths can be compared across engines.
+///
+/// The bindings bracket these calls in their scan paths with a Timer; it does
+/// nothing unless a ScanProfile exists. Deserializing the records is not
+/// included.
+///
+class ScanProfile {
+ public:
+  ///
+  /// The name of the property to enable the breakdown.
+  ///
+  static const std::string ENABLED_PROPERTY;
+  static const std::string ENABLED_DEFAULT;
+
+  enum Stage {
+    CREATE = 0,
+    SEEK,
+    NEXT,
+    MAXSTAGE
+  };
+
+  class Timer {
+   public:
+    Timer() : profile_(active_), start_(0) {}
+
+    void Start() {
+      if (profile_) {
+        start_ = utils::NanoClock::Now();
+      }
+    }
+
+    void Stop(Stage stage) {
+      if (profile_) {
+        profile_->stages_[stage]->Report(SCAN, utils::NanoClock::Now() - start_);
+      }
+    }
+
+   private:
+    ScanProfile *profile_;
+    uint64_t start_;
+  };
+
+  ///
+  /// Becomes the profile the bindings report to; only one may exist.
+  ///
+  ScanProfile(utils::Properties *props);
+  ~ScanProfile();
+
+  void Print();
+  void Export(ResultsExporter *exporter, const std::string &phase);
+  void Reset();
+
+ private:
+  static ScanProfile *active_;
+
+  Measurements *stages_[MAXSTAGE];
+};
+
+} // ycsbc
+
+#endif // YCSB_C_SCAN_PROFILE_H_
@@ -35,6 +35,12 @@ class ScrambledZipfianGenerator : public Generator<uint64_t> {
   uint64_t Next();
   uint64_t Last();
 
+  ///
+  /// Next() that also returns the popularity rank of the value, i.e. the
+  /// zipfian value before scrambling (0 is the most popular).
+  ///
+  uint64_t Next(uint64_t *rank);
+
  private:
   static constexpr double kUsedZipfianConstant = 0.99;
   static constexpr double kZetan = 26.46902820178302;
@@ -54,6 +60,11 @@ inline uint64_t ScrambledZipfianGenerator::Next() {
   return Scramble(generator_.Next());
 }
 
+inline uint64_t ScrambledZipfianGenerator::Next(uint64_t *rank) {
+  *rank = generator_.Next();
+  return Scramble(*rank);
+}
+
 inline uint64_t ScrambledZipfianGenerator::Last() {
   return Scramble(generator_.Last());
 }
@@ -0,0 +1,165 @@
+//
+//  shm_metrics.cc
+//  YCSB-cpp
+//
+
+#include "shm_metrics.h"
+#include "measurements.h"
+#include "utils/utils.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#ifdef YCSB_C_HAVE_SHM
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace ycsbc {
+
+const std::string ShmMetricsWriter::NAME_PROPERTY = "shm.name";
+const std::string ShmMetricsWriter::NAME_DEFAULT = "";
+
+const std::string ShmMetricsWriter::INTERVAL_PROPERTY = "shm.interval_ms";
+const std::string ShmMetricsWriter::INTERVAL_DEFAULT = "1000";
+
+namespace {
+  double Now() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  void CopyName(char *dst, size_t size, const std::string &src) {
+    size_t n = std::min(size - 1, src.size());
+    memcpy(dst, src.data(), n);
+    dst[n] = '\0';
+  }
+} // anonymous
+
+ShmMetricsWriter::ShmMetricsWriter(const std::string &name, const std::string &dbname)
+    : name_(name), segment_(nullptr), phase_start_(Now()), last_publish_(phase_start_), total_count_() {
+#ifdef YCSB_C_HAVE_SHM
+  int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0644);
+  if (fd < 0) {
+    throw utils::Exception("shm_open failed: " + name + ": " + strerror(errno));
+  }
+  if (ftruncate(fd, sizeof(shm::Segment)) != 0) {
+    close(fd);
+    throw utils::Exception("ftruncate failed: " + name + ": " + strerror(errno));
+  }
+  void *addr = mmap(nullptr, sizeof(shm::Segment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED) {
+    throw utils::Exception("mmap failed: " + name + ": " + strerror(errno));
+  }
+  segment_ = static_cast<shm::Segment *>(addr);
+  memset(static_cast<void *>(&segment_->snapshot), 0, sizeof(segment_->snapshot));
+  segment_->seq.store(0, std::memory_order_relaxed);
+  segment_->snapshot.state = shm::kIdle;
+  segment_->snapshot.pid = getpid();
+  CopyName(segment_->snapshot.dbname, sizeof(segment_->snapshot.dbname), dbname);
+  segment_->version = shm::kVersion;
+  // readers check the magic last
+  std::atomic_thread_fence(std::memory_order_release);
+  segment_->magic = shm::kMagic;
+#else
+  throw utils::Exception(NAME_PROPERTY + " is not supported on this platform");
+#endif
+}
+
+ShmMetricsWriter::~ShmMetricsWriter() {
+#ifdef YCSB_C_HAVE_SHM
+  munmap(segment_, sizeof(shm::Segment));
+  shm_unlink(name_.c_str());
+#endif
+}
+
+template <typename F>
+void ShmMetricsWriter::Update(F update) {
+  uint64_t seq = segment_->seq.load(std::memory_order_relaxed);
+  segment_->seq.store(seq + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  update(&segment_->snapshot);
+  segment_->snapshot.updates++;
+  segment_->seq.store(seq + 2, std::memory_order_release);
+}
+
+void ShmMetricsWriter::StartPhase(const std::string &phase) {
+  phase_start_ = Now();
+  last_publish_ = phase_start_;
+  std::fill(std::begin(total_count_), std::end(total_count_), 0);
+  Update([&](shm::Snapshot *s) {
+    s->state = shm::kRunning;
+    CopyName(s->phase, sizeof(s->phase), phase);
+    s->elapsed_sec = 0;
+    s->interval_sec = 0;
+    s->operations = 0;
+    s->num_ops = 0;
+    s->num_engine_metrics = 0;
+  });
+}
+
+void ShmMetricsWriter::Publish(Measurements *measurements, uint64_t operations,
+                               const std::map<std::string, double> &engine_metrics) {
+  // summarize before taking the lock, readers only wait for the copy
+  shm::OpStats ops[shm::kMaxOps];
+  uint32_t num_ops = 0;
+  for (int i = 0; i < MAXOPTYPE && num_ops < shm::kMaxOps; i++) {
+    Operation op = static_cast<Operation>(i);
+    OpSummary interval;
+    // totals add up the intervals, summarizing the whole phase every tick is too costly
+    bool has_interval = measurements->SummarizeInterval(op, &interval);
+    if (has_interval) {
+      total_count_[op] += interval.count;
+    }
+    if (total_count_[op] == 0) {
+      continue;
+    }
+    shm::OpStats &stats = ops[num_ops++];
+    memset(&stats, 0, sizeof(stats));
+    CopyName(stats.name, sizeof(stats.name), kOperationString[op]);
+    stats.total_count = total_count_[op];
+    if (has_interval) {
+      stats.interval_count = interval.count;
+      stats.mean_ns = interval.mean;
+      // percentiles stay 0 if the measurement type records none
+      interval.Percentile(50, &stats.p50_ns);
+      interval.Percentile(90, &stats.p90_ns);
+      interval.Percentile(99, &stats.p99_ns);
+      interval.Percentile(99.9, &stats.p999_ns);
+      stats.max_ns = interval.max;
+    }
+  }
+
+  double now = Now();
+  double interval_sec = now - last_publish_;
+  last_publish_ = now;
+  Update([&](shm::Snapshot *s) {
+    s->elapsed_sec = now - phase_start_;
+    s->interval_sec = interval_sec;
+    s->operations = operations;
+    s->num_ops = num_ops;
+    memcpy(s->ops, ops, num_ops * sizeof(shm::OpStats));
+    if (engine_metrics.empty()) {
+      return;
+    }
+    s->num_engine_metrics = 0;
+    for (auto &metric : engine_metrics) {
+      if (s->num_engine_metrics == shm::kMaxEngineMetrics) {
+        break;
+      }
+      shm::EngineMetric &m = s->engine_metrics[s->num_engine_metrics++];
+      CopyName(m.name, sizeof(m.name), metric.first);
+      m.value = metric.second;
+    }
+  });
+}
+
+void ShmMetricsWriter::FinishPhase() {
+  Update([&](shm::Snapshot *s) {
+    s->state = shm::kFinished;
+  });
+}
+
+} // ycsbc
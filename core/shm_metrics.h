@@ -0,0 +1,157 @@
+//
+//  shm_metrics.h
+//  YCSB-cpp
+//
+
+#ifndef YCSB_C_SHM_METRICS_H_
+#define YCSB_C_SHM_METRICS_H_
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <string>
+
+#include "core_workload.h"
+
+// POSIX shared memory (shm_open, mmap)
+#if defined(__unix__) || defined(__APPLE__)
+#define YCSB_C_HAVE_SHM
+#endif
+
+namespace ycsbc {
+
+///
+/// Layout of the POSIX shared memory segment live metrics are published to.
+/// Shared by the writer (ShmMetricsWriter) and readers (ycsb-top), so it only
+/// holds fixed-size plain data.
+///
+/// The snapshot is guarded by a sequence lock: the writer makes seq odd,
+/// updates the snapshot and makes seq even again. A reader copies the snapshot
+/// and retries if seq was odd or changed meanwhile, so readers never block
+/// the writer.
+///
+namespace shm {
+
+const uint32_t kMagic = 0x59435342; // "YCSB"
+const uint32_t kVersion = 1;
+const int kMaxOps = 16;
+const int kMaxEngineMetrics = 128;
+const int kNameLength = 64;
+
+enum State : uint32_t {
+  kIdle = 0,
+  kRunning,
+  kFinished
+};
+
+struct OpStats {
+  char name[16];
+  uint64_t total_count;    // since the start of the phase
+  uint64_t interval_count; // in the last interval
+  double mean_ns;          // of the last interval
+  // of the last interval, 0 if the measurement type keeps no histograms
+  uint64_t p50_ns;
+  uint64_t p90_ns;
+  uint64_t p99_ns;
+  uint64_t p999_ns;
+  uint64_t max_ns;
+};
+
+struct EngineMetric {
+  char name[kNameLength];
+  double value;
+};
+
+struct Snapshot {
+  uint32_t state;
+  int32_t pid;
+  char dbname[32];
+  char phase[16];
+  double elapsed_sec;  // since the start of the phase
+  double interval_sec; // length of the last interval
+  uint64_t operations; // since the start of the phase
+  uint64_t updates;    // number of publishes, to spot a stalled writer
+  uint32_t num_ops;
+  uint32_t num_engine_metrics;
+  OpStats ops[kMaxOps];
+  EngineMetric engine_metrics[kMaxEngineMetrics];
+};
+
+struct Segment {
+  uint32_t magic;
+  uint32_t version;
+  std::atomic<uint64_t> seq;
+  Snapshot snapshot;
+};
+
+///
+/// Copies a consistent snapshot out of segment, retrying while the writer
+/// is in the middle of an update.
+///
+inline void Read(const Segment *segment, Snapshot *snapshot) {
+  while (true) {
+    uint64_t begin = segment->seq.load(std::memory_order_acquire);
+    if (begin & 1) {
+      continue;
+    }
+    *snapshot = segment->snapshot;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (segment->seq.load(std::memory_order_relaxed) == begin) {
+      return;
+    }
+  }
+}
+
+} // shm
+
+class Measurements;
+
+///
+/// Creates the shared memory segment and publishes the live metrics of the
+/// running phase to it. Publish() is called by the status thread only; the
+/// client threads are not involved. Needs YCSB_C_HAVE_SHM, the constructor
+/// throws without it.
+///
+class ShmMetricsWriter {
+ public:
+  ///
+  /// The name of the property for the name of the segment, e.g. "/ycsb".
+  /// Nothing is published if empty.
+  ///
+  static const std::string NAME_PROPERTY;
+  static const std::string NAME_DEFAULT;
+
+  ///
+  /// The name of the property for the publish interval in milliseconds, used
+  /// as status interval if none is given.
+  ///
+  static const std::string INTERVAL_PROPERTY;
+  static const std::string INTERVAL_DEFAULT;
+
+  ShmMetricsWriter(const std::string &name, const std::string &dbname);
+  ~ShmMetricsWriter();
+
+  void StartPhase(const std::string &phase);
+
+  ///
+  /// Publishes the last finished interval of measurements. The previous
+  /// engine metrics are kept if engine_metrics is empty.
+  ///
+  void Publish(Measurements *measurements, uint64_t operations,
+               const std::map<std::string, double> &engine_metrics);
+
+  void FinishPhase();
+
+ private:
+  template <typename F> void Update(F update);
+
+  std::string name_;
+  shm::Segment *segment_;
+  double phase_start_;
+  double last_publish_;
+  uint64_t total_count_[MAXOPTYPE];
+};
+
+} // ycsbc
+
+#endif // YCSB_C_SHM_METRICS_H_
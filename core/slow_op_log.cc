@@ -0,0 +1,100 @@
+//
+//  slow_op_log.cc
+//  YCSB-cpp
+//
+
+#include "slow_op_log.h"
+#include "utils/utils.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <tuple>
+
+namespace ycsbc {
+
+const std::string SlowOpLog::THRESHOLD_PROPERTY = "slowop.threshold_us";
+const std::string SlowOpLog::THRESHOLD_DEFAULT = "0";
+
+const std::string SlowOpLog::CAPACITY_PROPERTY = "slowop.capacity";
+const std::string SlowOpLog::CAPACITY_DEFAULT = "10000";
+
+const std::string SlowOpLog::FILE_PROPERTY = "slowop.file";
+const std::string SlowOpLog::FILE_DEFAULT = "slowops.csv";
+
+void SlowOpLog::Thread::Capture(Operation op, uint64_t latency_ns, const std::string &key,
+                                size_t fields, int scan_length) {
+  uint64_t now_us = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count();
+  Entry entry{now_us - latency_ns / 1000, op, latency_ns, key, fields, scan_length};
+  if (ring_.size() < capacity_) {
+    ring_.push_back(std::move(entry));
+  } else {
+    ring_[captured_ % capacity_] = std::move(entry);
+  }
+  captured_++;
+}
+
+SlowOpLog::SlowOpLog(utils::Properties *props, int num_threads)
+    : path_(props->GetProperty(FILE_PROPERTY, FILE_DEFAULT)),
+      threshold_us_(std::stoull(props->GetProperty(THRESHOLD_PROPERTY, THRESHOLD_DEFAULT))),
+      truncate_(true) {
+  size_t capacity = std::stoull(props->GetProperty(CAPACITY_PROPERTY, CAPACITY_DEFAULT));
+  if (capacity == 0) {
+    throw utils::Exception(CAPACITY_PROPERTY + " must be positive");
+  }
+  for (int i = 0; i < num_threads; i++) {
+    threads_.push_back(new Thread(threshold_us_ * 1000, capacity));
+  }
+}
+
+SlowOpLog::~SlowOpLog() {
+  for (Thread *t : threads_) {
+    delete t;
+  }
+}
+
+void SlowOpLog::Dump(const std::string &phase) {
+  struct Row {
+    int thread;
+    const Thread::Entry *entry;
+  };
+  std::vector<Row> rows;
+  uint64_t captured = 0;
+  for (size_t i = 0; i < threads_.size(); i++) {
+    for (const Thread::Entry &entry : threads_[i]->ring_) {
+      rows.push_back(Row{static_cast<int>(i), &entry});
+    }
+    captured += threads_[i]->captured_;
+  }
+  std::sort(rows.begin(), rows.end(), [](const Row &a, const Row &b) {
+    return std::tie(a.entry->start_us, a.thread) < std::tie(b.entry->start_us, b.thread);
+  });
+
+  std::ofstream out(path_, truncate_ ? std::ios::trunc : std::ios::app);
+  if (!out) {
+    throw utils::Exception("failed to open: " + path_);
+  }
+  if (truncate_) {
+    out << "phase,thread,start_us,op,key,fields,scan_length,latency_us\n";
+    truncate_ = false;
+  }
+  for (const Row &row : rows) {
+    const Thread::Entry &e = *row.entry;
+    out << phase << ',' << row.thread << ',' << e.start_us << ',' << kOperationString[e.op] << ','
+        << e.key << ',' << e.fields << ',' << e.scan_length << ',' << e.latency_ns / 1000.0 << '\n';
+  }
+  if (!out) {
+    throw utils::Exception("failed to write: " + path_);
+  }
+  printf("slow ops (>= %lu us): %lu, last %zu written to %s\n", threshold_us_, captured,
+         rows.size(), path_.c_str());
+
+  for (Thread *t : threads_) {
+    t->ring_.clear();
+    t->captured_ = 0;
+  }
+}
+
+} // ycsbc
@@ -0,0 +1,106 @@
+//
+//  slow_op_log.h
+//  YCSB-cpp
+//
+
+#ifndef YCSB_C_SLOW_OP_LOG_H_
+#define YCSB_C_SLOW_OP_LOG_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "core_workload.h"
+#include "utils/properties.h"
+
+namespace ycsbc {
+
+///
+/// Captures the operations slower than slowop.threshold_us with their key,
+/// field count and scan length, to correlate latency outliers with hot keys,
+/// long scans or engine events at the same time.
+///
+/// Every client thread's DBWrapper keeps the last slowop.capacity slow
+/// operations in a ring buffer of its own; faster operations only cost a
+/// comparison. The buffers are written to slowop.file, sorted by time, at the
+/// end of each phase.
+///
+class SlowOpLog {
+ public:
+  ///
+  /// The name of the property for the latency threshold in microseconds.
+  /// Nothing is captured if 0.
+  ///
+  static const std::string THRESHOLD_PROPERTY;
+  static const std::string THRESHOLD_DEFAULT;
+
+  ///
+  /// The name of the property for the number of slow operations kept per thread.
+  ///
+  static const std::string CAPACITY_PROPERTY;
+  static const std::string CAPACITY_DEFAULT;
+
+  ///
+  /// The name of the property for the CSV file the slow operations are written to.
+  ///
+  static const std::string FILE_PROPERTY;
+  static const std::string FILE_DEFAULT;
+
+  class Thread {
+   public:
+    Thread(uint64_t threshold_ns, size_t capacity)
+        : threshold_ns_(threshold_ns), capacity_(capacity), captured_(0) {}
+
+    void Add(Operation op, uint64_t latency_ns, const std::string &key, size_t fields,
+             int scan_length) {
+      if (latency_ns < threshold_ns_) {
+        return;
+      }
+      Capture(op, latency_ns, key, fields, scan_length);
+    }
+
+   private:
+    friend class SlowOpLog;
+
+    struct Entry {
+      uint64_t start_us; // wall clock, microseconds since the epoch
+      Operation op;
+      uint64_t latency_ns;
+      std::string key;
+      size_t fields;   // 0 for all fields
+      int scan_length; // 0 if not a scan
+    };
+
+    void Capture(Operation op, uint64_t latency_ns, const std::string &key, size_t fields,
+                 int scan_length);
+
+    const uint64_t threshold_ns_;
+    const size_t capacity_;
+    uint64_t captured_; // including overwritten entries
+    std::vector<Entry> ring_;
+  };
+
+  SlowOpLog(utils::Properties *props, int num_threads);
+  ~SlowOpLog();
+
+  ///
+  /// The ring buffer of a client thread.
+  ///
+  Thread *ForThread(int thread_id) { return threads_[thread_id]; }
+
+  ///
+  /// Appends the slow operations of a finished phase to the file and empties
+  /// the buffers.
+  ///
+  void Dump(const std::string &phase);
+
+ private:
+  std::string path_;
+  uint64_t threshold_us_;
+  bool truncate_;
+  std::vector<Thread *> threads_;
+};
+
+} // ycsbc
+
+#endif // YCSB_C_SLOW_OP_LOG_H_
@@ -0,0 +1,191 @@
+//
+//  thread_measurements.cc
+//  YCSB-cpp
+//
+
+#include "thread_measurements.h"
+#include "utils/utils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <sstream>
+
+namespace ycsbc {
+
+const std::string PerThreadMeasurements::LATENCY_PROPERTY = "measurement.perthread";
+const std::string PerThreadMeasurements::LATENCY_DEFAULT = "false";
+
+PerThreadMeasurements::PerThreadMeasurements(utils::Properties *props, Measurements *measurements,
+                                             int num_threads)
+    : measurements_(measurements), interval_start_(std::chrono::steady_clock::now()),
+      interval_sec_(0) {
+  bool latencies = utils::StrToBool(props->GetProperty(LATENCY_PROPERTY, LATENCY_DEFAULT));
+  for (int i = 0; i < num_threads; i++) {
+    threads_.push_back(new Thread(measurements_, latencies ? CreateAuxiliaryMeasurements(props) : nullptr));
+  }
+}
+
+PerThreadMeasurements::~PerThreadMeasurements() {
+  for (Thread *t : threads_) {
+    delete t;
+  }
+  delete measurements_;
+}
+
+uint64_t PerThreadMeasurements::Operations() const {
+  uint64_t sum = 0;
+  for (Thread *t : threads_) {
+    if (!t->background) {
+      sum += t->ops.load(std::memory_order_relaxed);
+    }
+  }
+  return sum;
+}
+
+void PerThreadMeasurements::Thread::Reset() {
+  ops.store(0, std::memory_order_relaxed);
+  last_ops = 0;
+  if (latencies_) {
+    latencies_->Reset();
+  }
+}
+
+void PerThreadMeasurements::Reset() {
+  measurements_->Reset();
+  for (Thread *t : threads_) {
+    t->Reset();
+  }
+}
+
+void PerThreadMeasurements::FinishInterval() {
+  measurements_->FinishInterval();
+  std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+  interval_sec_ = std::chrono::duration<double>(now - interval_start_).count();
+  interval_start_ = now;
+  for (Thread *t : threads_) {
+    uint64_t ops = t->ops.load(std::memory_order_relaxed);
+    t->interval_ops = ops - std::min(ops, t->last_ops);
+    t->last_ops = ops;
+  }
+}
+
+std::string PerThreadMeasurements::GetIntervalStatusMsg() {
+  std::vector<double> rates;
+  for (Thread *t : threads_) {
+    rates.push_back(interval_sec_ > 0 ? t->interval_ops / interval_sec_ : 0);
+  }
+  rates = Foreground(rates);
+  std::ostringstream msg_stream;
+  msg_stream.precision(2);
+  msg_stream << std::fixed << " [THREADS: min=" << *std::min_element(rates.begin(), rates.end())
+             << " max=" << *std::max_element(rates.begin(), rates.end()) << " ops/sec "
+             << FairnessString(ComputeFairness(rates)) << "]";
+  return measurements_->GetIntervalStatusMsg() + msg_stream.str();
+}
+
+PerThreadMeasurements::Fairness PerThreadMeasurements::ComputeFairness(const std::vector<double> &rates) {
+  double sum = 0;
+  double sum_sq = 0;
+  double min_rate = std::numeric_limits<double>::max();
+  double max_rate = 0;
+  for (double x : rates) {
+    sum += x;
+    sum_sq += x * x;
+    min_rate = std::min(min_rate, x);
+    max_rate = std::max(max_rate, x);
+  }
+  Fairness fairness;
+  fairness.jain = sum_sq > 0 ? sum * sum / (rates.size() * sum_sq) : 1;
+  fairness.max_min = min_rate > 0 ? max_rate / min_rate
+                                  : (max_rate > 0 ? std::numeric_limits<double>::infinity() : 1);
+  return fairness;
+}
+
+std::string PerThreadMeasurements::FairnessString(const Fairness &fairness) {
+  std::ostringstream out;
+  out.precision(3);
+  out << std::fixed << "jain=" << fairness.jain << " max/min=";
+  if (std::isinf(fairness.max_min)) {
+    out << "inf";
+  } else {
+    out << fairness.max_min;
+  }
+  return out.str();
+}
+
+std::vector<double> PerThreadMeasurements::Throughput(const std::vector<double> &runtime_sec) const {
+  std::vector<double> rates;
+  for (size_t i = 0; i < threads_.size(); i++) {
+    uint64_t ops = threads_[i]->ops.load(std::memory_order_relaxed);
+    rates.push_back(runtime_sec[i] > 0 ? ops / runtime_sec[i] : 0);
+  }
+  return rates;
+}
+
+std::vector<double> PerThreadMeasurements::Foreground(const std::vector<double> &rates) const {
+  std::vector<double> foreground;
+  for (size_t i = 0; i < threads_.size(); i++) {
+    if (!threads_[i]->background) {
+      foreground.push_back(rates[i]);
+    }
+  }
+  return foreground;
+}
+
+void PerThreadMeasurements::Print(const std::vector<double> &runtime_sec) {
+  std::vector<double> rates = Throughput(runtime_sec);
+  printf("********** per-thread result **********\n");
+  for (size_t i = 0; i < threads_.size(); i++) {
+    printf("thread %zu: ops %lu  use time %.3f s  %.2f ops/sec%s", i,
+           threads_[i]->ops.load(std::memory_order_relaxed), runtime_sec[i], rates[i],
+           threads_[i]->background ? " (background)" : "");
+    for (int j = 0; j < MAXOPTYPE; j++) {
+      Operation op = static_cast<Operation>(j);
+      OpSummary summary;
+      if (!threads_[i]->Summarize(op, &summary)) {
+        continue;
+      }
+      printf("  [%s: Count=%lu Avg=%.2f", kOperationString[op], summary.count, summary.mean / 1000);
+      for (auto &p : summary.percentiles) {
+        if (p.first == 50 || p.first == 99 || p.first == 99.9) {
+          printf(" %g=%.2f", p.first, p.second / 1000.0);
+        }
+      }
+      printf(" us]");
+    }
+    printf("\n");
+  }
+  printf("fairness: %s\n", FairnessString(ComputeFairness(Foreground(rates))).c_str());
+  printf("***************************************\n");
+}
+
+void PerThreadMeasurements::Export(ResultsExporter *exporter, const std::string &phase,
+                                   const std::vector<double> &runtime_sec) {
+  std::vector<double> rates = Throughput(runtime_sec);
+  for (size_t i = 0; i < threads_.size(); i++) {
+    std::string prefix = "thread." + std::to_string(i);
+    exporter->AddMetric(phase, prefix + ".operations", threads_[i]->ops.load(std::memory_order_relaxed));
+    exporter->AddMetric(phase, prefix + ".runtime_sec", runtime_sec[i]);
+    exporter->AddMetric(phase, prefix + ".throughput", rates[i]);
+    for (int j = 0; j < MAXOPTYPE; j++) {
+      Operation op = static_cast<Operation>(j);
+      OpSummary summary;
+      if (!threads_[i]->Summarize(op, &summary)) {
+        continue;
+      }
+      for (auto &p : summary.percentiles) {
+        if (p.first == 50 || p.first == 99) {
+          exporter->AddMetric(phase, prefix + "." + kOperationString[op] + ".p" +
+                              std::to_string(static_cast<int>(p.first)), p.second);
+        }
+      }
+    }
+  }
+  Fairness fairness = ComputeFairness(Foreground(rates));
+  exporter->AddMetric(phase, "fairness.jain", fairness.jain);
+  exporter->AddMetric(phase, "fairness.max_min", fairness.max_min);
+}
+
+} // ycsbc
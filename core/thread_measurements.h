@@ -0,0 +1,135 @@
+//
+//  thread_measurements.h
+//  YCSB-cpp
+//
+
+#ifndef YCSB_C_THREAD_MEASUREMENTS_H_
+#define YCSB_C_THREAD_MEASUREMENTS_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "measurements.h"
+#include "results_exporter.h"
+#include "utils/properties.h"
+
+namespace ycsbc {
+
+///
+/// Measurements that also account every operation to the client thread that
+/// issued it. Each thread's DB reports to ForThread(thread_id); everything
+/// else is forwarded to the wrapped measurements. Per-thread op counts are
+/// always kept and summarized as a fairness index (Jain's index and max/min
+/// ratio of per-thread throughput) in the interval status and the final report.
+/// An operation is one workload transaction (AddOperation()), however many
+/// DB calls it takes, e.g. a queue dequeue's seek and delete.
+/// Per-thread latency histograms are kept if measurement.perthread=true.
+///
+class PerThreadMeasurements : public Measurements {
+ public:
+  ///
+  /// The name of the property to keep per-thread latency histograms.
+  ///
+  static const std::string LATENCY_PROPERTY;
+  static const std::string LATENCY_DEFAULT;
+
+  ///
+  /// Takes ownership of measurements.
+  ///
+  PerThreadMeasurements(utils::Properties *props, Measurements *measurements, int num_threads);
+  ~PerThreadMeasurements();
+
+  Measurements *ForThread(int thread_id) { return threads_[thread_id]; }
+
+  ///
+  /// Counts a finished transaction of a client thread.
+  ///
+  void AddOperation(int thread_id) {
+    std::atomic<uint64_t> &ops = threads_[thread_id]->ops;
+    // single writer; relaxed load and store instead of a locked add
+    ops.store(ops.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  }
+
+  ///
+  /// Marks a client thread as running in the background of the phase
+  /// (CoreWorkload::IsBackgroundThread()). Its operations are still counted
+  /// per thread, but left out of Operations() and the fairness index.
+  ///
+  void SetBackground(int thread_id, bool background) { threads_[thread_id]->background = background; }
+
+  ///
+  /// The number of operations done by all foreground threads since the last
+  /// Reset().
+  ///
+  uint64_t Operations() const;
+
+  void Report(Operation op, uint64_t latency) override { measurements_->Report(op, latency); }
+  std::string GetStatusMsg() override { return measurements_->GetStatusMsg(); }
+  void Reset() override;
+  void StartPhase(const std::string &phase) override { measurements_->StartPhase(phase); }
+  void FinishInterval() override;
+  std::string GetIntervalStatusMsg() override;
+  bool Summarize(Operation op, OpSummary *summary) override {
+    return measurements_->Summarize(op, summary);
+  }
+  bool SummarizeInterval(Operation op, OpSummary *summary) override {
+    return measurements_->SummarizeInterval(op, summary);
+  }
+
+  ///
+  /// Prints the per-thread report of a finished phase, given the time each
+  /// thread took. Fairness is computed over the per-thread throughput.
+  ///
+  void Print(const std::vector<double> &runtime_sec);
+  void Export(ResultsExporter *exporter, const std::string &phase, const std::vector<double> &runtime_sec);
+
+ private:
+  class Thread : public Measurements {
+   public:
+    Thread(Measurements *measurements, Measurements *latencies)
+        : ops(0), measurements_(measurements), latencies_(latencies) {}
+    ~Thread() { delete latencies_; }
+
+    void Report(Operation op, uint64_t latency) override {
+      measurements_->Report(op, latency);
+      if (latencies_) {
+        latencies_->Report(op, latency);
+      }
+    }
+    std::string GetStatusMsg() override { return ""; }
+    void Reset() override;
+    bool Summarize(Operation op, OpSummary *summary) override {
+      return latencies_ && latencies_->Summarize(op, summary);
+    }
+
+    alignas(64) std::atomic<uint64_t> ops;
+    uint64_t last_ops = 0;
+    uint64_t interval_ops = 0;
+    bool background = false;
+
+   private:
+    Measurements *measurements_;
+    Measurements *latencies_;
+  };
+
+  struct Fairness {
+    double jain;
+    double max_min; // infinite if a thread did nothing
+  };
+  static Fairness ComputeFairness(const std::vector<double> &rates);
+  static std::string FairnessString(const Fairness &fairness);
+  std::vector<double> Throughput(const std::vector<double> &runtime_sec) const;
+  std::vector<double> Foreground(const std::vector<double> &rates) const;
+
+  Measurements *measurements_;
+  std::vector<Thread *> threads_;
+  std::chrono::steady_clock::time_point interval_start_;
+  double interval_sec_;
+};
+
+} // ycsbc
+
+#endif // YCSB_C_THREAD_MEASUREMENTS_H_
@@ -0,0 +1,83 @@
+//
+//  timeseries_workload.cc
+//  YCSB-cpp
+//
+
+#include "timeseries_workload.h"
+#include "uniform_generator.h"
+#include "utils/utils.h"
+
+#include <algorithm>
+#include <string>
+
+using std::string;
+
+namespace ycsbc {
+
+const string TimeSeriesWorkload::SERIES_COUNT_PROPERTY = "timeseries.seriescount";
+const string TimeSeriesWorkload::SERIES_COUNT_DEFAULT = "100";
+
+const string TimeSeriesWorkload::TIMESTAMP_START_PROPERTY = "timeseries.timestampstart";
+const string TimeSeriesWorkload::TIMESTAMP_START_DEFAULT = "0";
+
+const string TimeSeriesWorkload::TIMESTAMP_INTERVAL_PROPERTY = "timeseries.timestampinterval";
+const string TimeSeriesWorkload::TIMESTAMP_INTERVAL_DEFAULT = "1";
+
+const string TimeSeriesWorkload::SCAN_WINDOW_PROPERTY = "timeseries.scanwindow";
+const string TimeSeriesWorkload::SCAN_WINDOW_DEFAULT = "60";
+
+namespace {
+  // wide enough for nanosecond epoch timestamps, keeps keys in time order
+  const int kTimestampWidth = 19;
+} // anonymous
+
+void TimeSeriesWorkload::Init(const utils::Properties &p) {
+  CoreWorkload::Init(p);
+
+  series_count_ = std::stoull(p.GetProperty(SERIES_COUNT_PROPERTY, SERIES_COUNT_DEFAULT));
+  timestamp_start_ = std::stoull(p.GetProperty(TIMESTAMP_START_PROPERTY, TIMESTAMP_START_DEFAULT));
+  timestamp_interval_ = std::stoull(p.GetProperty(TIMESTAMP_INTERVAL_PROPERTY,
+                                                  TIMESTAMP_INTERVAL_DEFAULT));
+  uint64_t window = std::stoull(p.GetProperty(SCAN_WINDOW_PROPERTY, SCAN_WINDOW_DEFAULT));
+  if (series_count_ == 0) {
+    throw utils::Exception("timeseries.seriescount must be positive");
+  }
+  if (timestamp_interval_ == 0) {
+    throw utils::Exception("timeseries.timestampinterval must be positive");
+  }
+  window_points_ = std::max<uint64_t>(1, window / timestamp_interval_);
+  series_width_ = std::to_string(series_count_ - 1).size();
+  series_chooser_ = new UniformGenerator(0, series_count_ - 1);
+}
+
+std::string TimeSeriesWorkload::BuildPointKey(uint64_t series, uint64_t point) {
+  std::string series_str = std::to_string(series);
+  std::string ts_str = std::to_string(timestamp_start_ + point * timestamp_interval_);
+  std::string key = "user";
+  key.append(std::max(0, series_width_ - static_cast<int>(series_str.size())), '0').append(series_str);
+  key.append(std::max(0, kTimestampWidth - static_cast<int>(ts_str.size())), '0').append(ts_str);
+  return key;
+}
+
+std::string TimeSeriesWorkload::BuildKeyName(uint64_t key_num) {
+  return BuildPointKey(key_num % series_count_, key_num / series_count_);
+}
+
+DB::Status TimeSeriesWorkload::TransactionScan(DB &db) {
+  uint64_t series = series_chooser_->Next();
+  uint64_t last = transaction_insert_key_sequence_->Last();
+  uint64_t newest = (last < series) ? 0 : (last - series) / series_count_;
+  uint64_t oldest = (newest + 1 > window_points_) ? newest + 1 - window_points_ : 0;
+  const std::string key = BuildPointKey(series, oldest);
+  int len = static_cast<int>(newest - oldest + 1);
+  std::vector<std::vector<DB::Field>> result;
+  if (!read_all_fields()) {
+    std::vector<std::string> fields;
+    fields.push_back(NextFieldName());
+    return db.Scan(table_name_, key, len, &fields, result);
+  } else {
+    return db.Scan(table_name_, key, len, NULL, result);
+  }
+}
+
+} // ycsbc
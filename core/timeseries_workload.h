@@ -0,0 +1,81 @@
+//
+//  timeseries_workload.h
+//  YCSB-cpp
+//
+
+#ifndef YCSB_C_TIMESERIES_WORKLOAD_H_
+#define YCSB_C_TIMESERIES_WORKLOAD_H_
+
+#include <string>
+#include "core_workload.h"
+#include "generator.h"
+#include "utils/properties.h"
+
+namespace ycsbc {
+
+///
+/// Append-only time-series workload.
+/// Records are keyed by (series, timestamp). Key number n is the
+/// (n / seriescount)-th point of series (n % seriescount), so both load and
+/// transaction inserts append to every series in timestamp order. Scans read
+/// the trailing window of one series; reads and updates hit single points
+/// chosen by the request distribution.
+///
+class TimeSeriesWorkload : public CoreWorkload {
+ public:
+  ///
+  /// The name of the property for the number of series.
+  ///
+  static const std::string SERIES_COUNT_PROPERTY;
+  static const std::string SERIES_COUNT_DEFAULT;
+
+  ///
+  /// The name of the property for the timestamp of the first point.
+  ///
+  static const std::string TIMESTAMP_START_PROPERTY;
+  static const std::string TIMESTAMP_START_DEFAULT;
+
+  ///
+  /// The name of the property for the timestamp distance between two
+  /// consecutive points of a series (e.g. seconds).
+  ///
+  static const std::string TIMESTAMP_INTERVAL_PROPERTY;
+  static const std::string TIMESTAMP_INTERVAL_DEFAULT;
+
+  ///
+  /// The name of the property for the length of the trailing scan window,
+  /// in timestamp units.
+  ///
+  static const std::string SCAN_WINDOW_PROPERTY;
+  static const std::string SCAN_WINDOW_DEFAULT;
+
+  void Init(const utils::Properties &p) override;
+  // scans choose a series, not a key number
+  bool NextAccessKeyNum(uint64_t *key_num) override { return false; }
+
+  TimeSeriesWorkload() :
+      series_count_(0), timestamp_start_(0), timestamp_interval_(0), window_points_(0),
+      series_width_(0), series_chooser_(nullptr) {
+  }
+
+  ~TimeSeriesWorkload() {
+    delete series_chooser_;
+  }
+
+ protected:
+  std::string BuildKeyName(uint64_t key_num) override;
+  DB::Status TransactionScan(DB &db) override;
+
+  std::string BuildPointKey(uint64_t series, uint64_t point);
+
+  uint64_t series_count_;
+  uint64_t timestamp_start_;
+  uint64_t timestamp_interval_;
+  uint64_t window_points_;
+  int series_width_;
+  Generator<uint64_t> *series_chooser_;
+};
+
+} // ycsbc
+
+#endif // YCSB_C_TIMESERIES_WORKLOAD_H_
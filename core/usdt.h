@@ -0,0 +1,45 @@
+//
+//  usdt.h
+//  YCSB-cpp
+//
+
+#ifndef YCSB_C_USDT_H_
+#define YCSB_C_USDT_H_
+
+///
+/// Static tracepoints (USDT) of provider "ycsb" for bpftrace, perf probe and
+/// SystemTap. A probe site is a single nop and an ELF note; tracers patch it
+/// when attached. Without <sys/sdt.h> (systemtap-sdt-dev) or with
+/// -DYCSB_NO_USDT the probes compile to nothing.
+///
+///   op__start(int op, const char *key, size_t key_len)
+///   op__end(int op, const char *key, size_t key_len, uint64_t latency_ns)
+///     op is an Operation; at the end the *_FAILED type if the DB failed it
+///   phase__start(const char *phase)
+///   phase__end(const char *phase, uint64_t ops, uint64_t runtime_us)
+///   status__tick(const char *phase, uint64_t elapsed_ms, uint64_t ops)
+///
+/// e.g. bpftrace -e 'usdt:./ycsb:ycsb:op__end { @[arg0] = hist(arg3); }'
+///
+
+#if !defined(YCSB_NO_USDT) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define YCSB_USDT 1
+#endif
+#endif
+
+#ifdef YCSB_USDT
+#define YCSB_PROBE1(name, a1) DTRACE_PROBE1(ycsb, name, a1)
+#define YCSB_PROBE3(name, a1, a2, a3) DTRACE_PROBE3(ycsb, name, a1, a2, a3)
+#define YCSB_PROBE4(name, a1, a2, a3, a4) DTRACE_PROBE4(ycsb, name, a1, a2, a3, a4)
+#else
+// the arguments are not evaluated
+#define YCSB_PROBE1(name, a1) do { (void)sizeof(a1); } while (0)
+#define YCSB_PROBE3(name, a1, a2, a3) \
+  do { (void)sizeof(a1); (void)sizeof(a2); (void)sizeof(a3); } while (0)
+#define YCSB_PROBE4(name, a1, a2, a3, a4) \
+  do { (void)sizeof(a1); (void)sizeof(a2); (void)sizeof(a3); (void)sizeof(a4); } while (0)
+#endif
+
+#endif // YCSB_C_USDT_H_
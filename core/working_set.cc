@@ -0,0 +1,124 @@
+//
+//  working_set.cc
+//  YCSB-cpp
+//
+
+#include "working_set.h"
+#include "core_workload.h"
+#include "utils/utils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+
+namespace ycsbc {
+
+const std::string WorkingSet::ENABLED_PROPERTY = "measurement.workingset";
+const std::string WorkingSet::ENABLED_DEFAULT = "false";
+
+WorkingSet::WorkingSet(utils::Properties *props, int num_threads)
+    : record_bytes_(CoreWorkload::EstimatedRecordBytes(*props)) {
+  for (int i = 0; i < num_threads; i++) {
+    threads_.push_back(new Thread());
+  }
+  Reset();
+}
+
+WorkingSet::~WorkingSet() {
+  for (Thread *t : threads_) {
+    delete t;
+  }
+}
+
+double WorkingSet::Estimate(const uint8_t *registers) {
+  const double m = kRegisters;
+  double sum = 0;
+  int zeros = 0;
+  for (int i = 0; i < kRegisters; i++) {
+    sum += std::ldexp(1.0, -registers[i]);
+    if (registers[i] == 0) {
+      zeros++;
+    }
+  }
+  double estimate = 0.7213 / (1 + 1.079 / m) * m * m / sum;
+  if (estimate <= 2.5 * m && zeros > 0) {
+    // linear counting is more accurate for small sets
+    estimate = m * std::log(m / zeros);
+  }
+  return estimate;
+}
+
+void WorkingSet::Drain(uint8_t *interval) {
+  memset(interval, 0, kRegisters);
+  for (Thread *t : threads_) {
+    for (int i = 0; i < kRegisters; i++) {
+      interval[i] = std::max(interval[i], t->registers_[i].exchange(0, std::memory_order_relaxed));
+    }
+  }
+  for (int i = 0; i < kRegisters; i++) {
+    phase_[i] = std::max(phase_[i], interval[i]);
+  }
+}
+
+void WorkingSet::FinishInterval() {
+  uint8_t interval[kRegisters];
+  std::lock_guard<std::mutex> lock(mutex_);
+  Drain(interval);
+  interval_distinct_ = Estimate(interval);
+  peak_interval_distinct_ = std::max(peak_interval_distinct_, interval_distinct_);
+  has_interval_ = true;
+}
+
+std::string WorkingSet::GetIntervalStatusMsg() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  double phase_distinct = Estimate(phase_);
+  std::ostringstream msg_stream;
+  msg_stream.precision(2);
+  msg_stream << std::fixed << " [WORKING SET: interval distinct="
+             << static_cast<uint64_t>(interval_distinct_) << " (" << interval_distinct_ * record_bytes_ / utils::kMB
+             << " MB) total distinct=" << static_cast<uint64_t>(phase_distinct) << " ("
+             << phase_distinct * record_bytes_ / utils::kMB << " MB)]";
+  return msg_stream.str();
+}
+
+void WorkingSet::Print() {
+  uint8_t interval[kRegisters];
+  std::lock_guard<std::mutex> lock(mutex_);
+  Drain(interval);
+  double distinct = Estimate(phase_);
+  printf("********** working set **********\n");
+  printf("distinct keys (est.): %.0f  working set (est.): %.2f MB  record size (est.): %lu bytes\n",
+         distinct, distinct * record_bytes_ / utils::kMB, record_bytes_);
+  if (has_interval_) {
+    printf("peak interval: %.0f distinct keys  %.2f MB\n", peak_interval_distinct_,
+           peak_interval_distinct_ * record_bytes_ / utils::kMB);
+  }
+  printf("*********************************\n");
+}
+
+void WorkingSet::Export(ResultsExporter *exporter, const std::string &phase) {
+  uint8_t interval[kRegisters];
+  std::lock_guard<std::mutex> lock(mutex_);
+  Drain(interval);
+  double distinct = Estimate(phase_);
+  exporter->AddMetric(phase, "workingset.distinct_keys", distinct);
+  exporter->AddMetric(phase, "workingset.bytes", distinct * record_bytes_);
+  if (has_interval_) {
+    exporter->AddMetric(phase, "workingset.peak_interval_distinct_keys", peak_interval_distinct_);
+    exporter->AddMetric(phase, "workingset.peak_interval_bytes", peak_interval_distinct_ * record_bytes_);
+  }
+}
+
+void WorkingSet::Reset() {
+  uint8_t interval[kRegisters];
+  std::lock_guard<std::mutex> lock(mutex_);
+  Drain(interval);
+  memset(phase_, 0, kRegisters);
+  interval_distinct_ = 0;
+  peak_interval_distinct_ = 0;
+  has_interval_ = false;
+}
+
+} // ycsbc
@@ -0,0 +1,102 @@
+//
+//  working_set.h
+//  YCSB-cpp
+//
+
+#ifndef YCSB_C_WORKING_SET_H_
+#define YCSB_C_WORKING_SET_H_
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "results_exporter.h"
+#include "utils/properties.h"
+
+namespace ycsbc {
+
+///
+/// Estimates how many distinct keys the operations touch, per status
+/// interval and per phase, with HyperLogLog sketches (2^14 one-byte
+/// registers, about 0.8% standard error), and turns them into a working-set
+/// size with the estimated record size.
+///
+/// Every client thread adds the keys it operates on to a sketch of its own;
+/// the status thread drains these into the interval and the phase sketch.
+/// A scan only counts its start key.
+///
+class WorkingSet {
+ public:
+  ///
+  /// The name of the property to enable the estimate.
+  ///
+  static const std::string ENABLED_PROPERTY;
+  static const std::string ENABLED_DEFAULT;
+
+  static const int kPrecision = 14;
+  static const int kRegisters = 1 << kPrecision;
+
+  class Thread {
+   public:
+    Thread() : registers_(kRegisters) {}
+
+    void Add(const std::string &key) {
+      uint64_t h = Mix(std::hash<std::string>()(key));
+      uint32_t idx = h >> (64 - kPrecision);
+      // the sentinel bit bounds the rank to 64 - kPrecision + 1
+      uint8_t rank = __builtin_clzll((h << kPrecision) | (1ull << (kPrecision - 1))) + 1;
+      std::atomic<uint8_t> &r = registers_[idx];
+      if (rank > r.load(std::memory_order_relaxed)) {
+        r.store(rank, std::memory_order_relaxed);
+      }
+    }
+
+   private:
+    friend class WorkingSet;
+
+    static uint64_t Mix(uint64_t h) {
+      // splitmix64 finalizer, std::hash of a string need not be well spread
+      h ^= h >> 30;
+      h *= 0xbf58476d1ce4e5b9ull;
+      h ^= h >> 27;
+      h *= 0x94d049bb133111ebull;
+      return h ^ (h >> 31);
+    }
+
+    std::vector<std::atomic<uint8_t>> registers_;
+  };
+
+  WorkingSet(utils::Properties *props, int num_threads);
+  ~WorkingSet();
+
+  Thread *ForThread(int thread_id) { return threads_[thread_id]; }
+
+  ///
+  /// Drains the thread sketches into a new interval, called by the status thread.
+  ///
+  void FinishInterval();
+  std::string GetIntervalStatusMsg();
+
+  void Print();
+  void Export(ResultsExporter *exporter, const std::string &phase);
+  void Reset();
+
+ private:
+  static double Estimate(const uint8_t *registers);
+  void Drain(uint8_t *interval);
+
+  uint64_t record_bytes_;
+  std::vector<Thread *> threads_;
+  std::mutex mutex_;
+  uint8_t phase_[kRegisters];
+  double interval_distinct_;
+  double peak_interval_distinct_;
+  bool has_interval_;
+};
+
+} // ycsbc
+
+#endif // YCSB_C_WORKING_SET_H_
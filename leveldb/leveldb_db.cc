@@ -9,8 +9,11 @@
 #include "leveldb_db.h"
 #include "core/core_workload.h"
 #include "core/db_factory.h"
+#include "core/scan_profile.h"
 #include "utils/utils.h"
 
+#include <sstream>
+
 
 
 namespace {
@@ -69,6 +72,7 @@ namespace {
 namespace ycsbc {
 
 leveldb::DB *LeveldbDB::db_ = nullptr;
+leveldb::Cache *LeveldbDB::block_cache_ = nullptr;
 int LeveldbDB::ref_cnt_ = 0;
 std::mutex LeveldbDB::mu_;
 
@@ -122,6 +126,7 @@ void LeveldbDB::Init() {
 
   leveldb::Options opt;
   GetOptions(props, &opt);
+  block_cache_ = opt.block_cache;
   // opt.create_if_missing = true;
   // opt.compression = leveldb::kNoCompression;
   // opt.write_buffer_size = (16 << 20);
@@ -159,6 +164,7 @@ void LeveldbDB::Init() {
 }
 
 void LeveldbDB::Cleanup() {
+  ReleaseSnapshot();
   const std::lock_guard<std::mutex> lock(mu_);
   if (--ref_cnt_) {
     return;
@@ -166,6 +172,21 @@ void LeveldbDB::Cleanup() {
   // delete db_;
 }
 
+DB::Status LeveldbDB::StartSnapshot() {
+  if (snapshot_ == nullptr) {
+    snapshot_ = db_->GetSnapshot();
+  }
+  return kOK;
+}
+
+DB::Status LeveldbDB::ReleaseSnapshot() {
+  if (snapshot_ != nullptr) {
+    db_->ReleaseSnapshot(snapshot_);
+    snapshot_ = nullptr;
+  }
+  return kOK;
+}
+
 void LeveldbDB::GetOptions(const utils::Properties &props, leveldb::Options *opt) {
   size_t writer_buffer_size = std::stol(props.GetProperty(PROP_WRITE_BUFFER_SIZE,
                                                           PROP_WRITE_BUFFER_SIZE_DEFAULT));
@@ -329,7 +350,7 @@ DB::Status LeveldbDB::ReadSingleEntry(const std::string &table, const std::strin
                                       const std::vector<std::string> *fields,
                                       std::vector<Field> &result) {
   std::string data;
-  leveldb::Status s = db_->Get(leveldb::ReadOptions(), key, &data);
+  leveldb::Status s = db_->Get(SnapshotReadOptions(), key, &data);
   if (s.IsNotFound()) {
     return kNotFound;
   } else if (!s.ok()) {
@@ -346,8 +367,13 @@ DB::Status LeveldbDB::ReadSingleEntry(const std::string &table, const std::strin
 DB::Status LeveldbDB::ScanSingleEntry(const std::string &table, const std::string &key, int len,
                                       const std::vector<std::string> *fields,
                                       std::vector<std::vector<Field>> &result) {
-  leveldb::Iterator *db_iter = db_->NewIterator(leveldb::ReadOptions());
+  ScanProfile::Timer timer;
+  timer.Start();
+  leveldb::Iterator *db_iter = db_->NewIterator(SnapshotReadOptions());
+  timer.Stop(ScanProfile::CREATE);
+  timer.Start();
   db_iter->Seek(key);
+  timer.Stop(ScanProfile::SEEK);
   for (int i = 0; db_iter->Valid() && i < len; i++) {
     std::string data = db_iter->value().ToString();
     result.push_back(std::vector<Field>());
@@ -357,7 +383,9 @@ DB::Status LeveldbDB::ScanSingleEntry(const std::string &table, const std::strin
     } else {
       DeserializeRow(&values, data);
     }
+    timer.Start();
     db_iter->Next();
+    timer.Stop(ScanProfile::NEXT);
   }
   delete db_iter;
   return kOK;
@@ -434,7 +462,7 @@ DB::Status LeveldbDB::DeleteSingleEntry(const std::string &table, const std::str
 DB::Status LeveldbDB::ReadCompKeyRM(const std::string &table, const std::string &key,
                                     const std::vector<std::string> *fields,
                                     std::vector<Field> &result) {
-  leveldb::Iterator *db_iter = db_->NewIterator(leveldb::ReadOptions());
+  leveldb::Iterator *db_iter = db_->NewIterator(SnapshotReadOptions());
   db_iter->Seek(key);
   if (!db_iter->Valid() || KeyFromCompKey(db_iter->key().ToString()) != key) {
     return kNotFound;
@@ -477,8 +505,14 @@ DB::Status LeveldbDB::ReadCompKeyRM(const std::string &table, const std::string
 DB::Status LeveldbDB::ScanCompKeyRM(const std::string &table, const std::string &key, int len,
                                     const std::vector<std::string> *fields,
                                     std::vector<std::vector<Field>> &result) {
-  leveldb::Iterator *db_iter = db_->NewIterator(leveldb::ReadOptions());
+  // a record is fieldcount entries, every step to the next field is a NEXT
+  ScanProfile::Timer timer;
+  timer.Start();
+  leveldb::Iterator *db_iter = db_->NewIterator(SnapshotReadOptions());
+  timer.Stop(ScanProfile::CREATE);
+  timer.Start();
   db_iter->Seek(key);
+  timer.Stop(ScanProfile::SEEK);
   assert(db_iter->Valid() && KeyFromCompKey(db_iter->key().ToString()) == key);
   for (int i = 0; i < len && db_iter->Valid(); i++) {
     result.push_back(std::vector<Field>());
@@ -496,7 +530,9 @@ DB::Status LeveldbDB::ScanCompKeyRM(const std::string &table, const std::string
           values.push_back({cur_field, cur_val});
           filter_iter++;
         }
+        timer.Start();
         db_iter->Next();
+        timer.Stop(ScanProfile::NEXT);
       }
       assert(values.size() == fields->size());
     } else {
@@ -508,7 +544,9 @@ DB::Status LeveldbDB::ScanCompKeyRM(const std::string &table, const std::string
         assert(cur_field == field_prefix_ + std::to_string(j));
 
         values.push_back({cur_field, cur_val});
+        timer.Start();
         db_iter->Next();
+        timer.Stop(ScanProfile::NEXT);
       }
       assert(values.size() == fieldcount_);
     }
@@ -564,6 +602,48 @@ DB::Status LeveldbDB::DeleteCompKey(const std::string &table, const std::string
   return kOK;
 }
 
+DB::Status LeveldbDB::GetMetrics(std::map<std::string, double> *metrics) {
+  // the handle is shared with, and closed by, the client threads
+  const std::lock_guard<std::mutex> lock(mu_);
+  if (db_ == nullptr) {
+    return kError;
+  }
+  std::string value;
+  for (int level = 0; ; level++) {
+    std::string name = "leveldb.num-files-at-level" + std::to_string(level);
+    if (!db_->GetProperty(name, &value)) {
+      break;
+    }
+    (*metrics)[name] = std::stod(value);
+  }
+  // level sizes and compaction traffic are only exposed in the stats table:
+  // "level files size(MB) time(sec) read(MB) write(MB)" per non-empty level
+  if (db_->GetProperty("leveldb.stats", &value)) {
+    std::istringstream stats(value);
+    std::string line;
+    while (std::getline(stats, line)) {
+      std::istringstream row(line);
+      int level;
+      double files, size_mb, time_sec, read_mb, write_mb;
+      if (row >> level >> files >> size_mb >> time_sec >> read_mb >> write_mb) {
+        std::string prefix = "leveldb.level" + std::to_string(level);
+        (*metrics)[prefix + ".size-mb"] = size_mb;
+        (*metrics)[prefix + ".compaction-sec"] = time_sec;
+        (*metrics)[prefix + ".compaction-read-mb"] = read_mb;
+        (*metrics)[prefix + ".compaction-write-mb"] = write_mb;
+      }
+    }
+  }
+  // memtables, immutable memtable and block cache
+  if (db_->GetProperty("leveldb.approximate-memory-usage", &value)) {
+    (*metrics)["leveldb.approximate-memory-usage"] = std::stod(value);
+  }
+  if (block_cache_ != nullptr) {
+    (*metrics)["leveldb.block-cache-usage"] = block_cache_->TotalCharge();
+  }
+  return kOK;
+}
+
 void LeveldbDB::PrintStats() {
     std::string stats;
     if(nullptr == db_)
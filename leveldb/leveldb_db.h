@@ -9,6 +9,7 @@
 #define YCSB_C_LEVELDB_DB_H_
 
 #include <iostream>
+#include <map>
 #include <string>
 #include <mutex>
 
@@ -41,6 +42,8 @@ class LeveldbDB : public DB {
   
   void PrintStats();
 
+  Status GetMetrics(std::map<std::string, double> *metrics);
+
   Status Read(const std::string &table, const std::string &key,
               const std::vector<std::string> *fields, std::vector<Field> &result) {
     return (this->*(method_read_))(table, key, fields, result);
@@ -63,6 +66,10 @@ class LeveldbDB : public DB {
     return (this->*(method_delete_))(table, key);
   }
 
+  Status StartSnapshot();
+
+  Status ReleaseSnapshot();
+
  private:
   enum LdbFormat {
     kSingleEntry,
@@ -117,10 +124,19 @@ class LeveldbDB : public DB {
                                       std::vector<Field> &);
   Status (LeveldbDB::*method_delete_)(const std::string &, const std::string &);
 
+  // reads and scans of this instance see snapshot_ while it is held
+  leveldb::ReadOptions SnapshotReadOptions() const {
+    leveldb::ReadOptions ropt;
+    ropt.snapshot = snapshot_;
+    return ropt;
+  }
+
   int fieldcount_;
+  const leveldb::Snapshot *snapshot_{nullptr};
   std::string field_prefix_;
 
   static leveldb::DB *db_;
+  static leveldb::Cache *block_cache_;
   static int ref_cnt_;
   static std::mutex mu_;
 };
@@ -10,13 +10,17 @@
 
 #include "core/core_workload.h"
 #include "core/db_factory.h"
+#include "core/scan_profile.h"
 #include "utils/utils.h"
 
 #include <rocksdb/cache.h>
 #include <rocksdb/filter_policy.h>
 #include <rocksdb/merge_operator.h>
+#include <rocksdb/perf_context.h>
+#include <rocksdb/perf_level.h>
 #include <rocksdb/status.h>
 #include <rocksdb/utilities/options_util.h>
+#include <rocksdb/utilities/transaction.h>
 #include <rocksdb/write_batch.h>
 
 namespace {
@@ -29,6 +33,9 @@ namespace {
   const std::string PROP_MERGEUPDATE = "rocksdb.mergeupdate";
   const std::string PROP_MERGEUPDATE_DEFAULT = "false";
 
+  const std::string PROP_RMW_TRANSACTION = "rocksdb.rmw_transaction";
+  const std::string PROP_RMW_TRANSACTION_DEFAULT = "false";
+
   const std::string PROP_DESTROY = "rocksdb.destroy";
   const std::string PROP_DESTROY_DEFAULT = "false";
 
@@ -115,6 +122,7 @@ namespace ycsbc {
 
 std::vector<rocksdb::ColumnFamilyHandle *> RocksdbDB::cf_handles_;
 rocksdb::DB *RocksdbDB::db_ = nullptr;
+rocksdb::OptimisticTransactionDB *RocksdbDB::txn_db_ = nullptr;
 int RocksdbDB::ref_cnt_ = 0;
 std::mutex RocksdbDB::mu_;
 
@@ -172,11 +180,15 @@ void RocksdbDB::Init() {
     method_update_ = &RocksdbDB::UpdateSingle;
     method_insert_ = &RocksdbDB::InsertSingle;
     method_delete_ = &RocksdbDB::DeleteSingle;
+    method_rmw_ = &RocksdbDB::ReadModifyWriteSingle;
 #ifdef USE_MERGEUPDATE
     if (props.GetProperty(PROP_MERGEUPDATE, PROP_MERGEUPDATE_DEFAULT) == "true") {
       method_update_ = &RocksdbDB::MergeSingle;
     }
 #endif
+    if (props.GetProperty(PROP_RMW_TRANSACTION, PROP_RMW_TRANSACTION_DEFAULT) == "true") {
+      method_rmw_ = &RocksdbDB::ReadModifyWriteTransaction;
+    }
   } else {
     throw utils::Exception("unknown format");
   }
@@ -208,7 +220,14 @@ void RocksdbDB::Init() {
       throw utils::Exception(std::string("RocksDB DestroyDB: ") + s.ToString());
     }
   }
-  if (cf_descs.empty()) {
+  if (props.GetProperty(PROP_RMW_TRANSACTION, PROP_RMW_TRANSACTION_DEFAULT) == "true") {
+    if (cf_descs.empty()) {
+      s = rocksdb::OptimisticTransactionDB::Open(opt, db_path, &txn_db_);
+    } else {
+      s = rocksdb::OptimisticTransactionDB::Open(opt, db_path, cf_descs, &cf_handles_, &txn_db_);
+    }
+    db_ = txn_db_;
+  } else if (cf_descs.empty()) {
     s = rocksdb::DB::Open(opt, db_path, &db_);
   } else {
     s = rocksdb::DB::Open(opt, db_path, cf_descs, &cf_handles_, &db_);
@@ -219,6 +238,7 @@ void RocksdbDB::Init() {
 }
 
 void RocksdbDB::Cleanup() { 
+  ReleaseSnapshot();
   const std::lock_guard<std::mutex> lock(mu_);
   if (--ref_cnt_) {
     return;
@@ -230,6 +250,73 @@ void RocksdbDB::Cleanup() {
     }
   }
   delete db_;
+  db_ = nullptr;
+  txn_db_ = nullptr;
+}
+
+DB::Status RocksdbDB::StartSnapshot() {
+  if (snapshot_ == nullptr) {
+    snapshot_ = db_->GetSnapshot();
+  }
+  return kOK;
+}
+
+DB::Status RocksdbDB::ReleaseSnapshot() {
+  if (snapshot_ != nullptr) {
+    db_->ReleaseSnapshot(snapshot_);
+    snapshot_ = nullptr;
+  }
+  return kOK;
+}
+
+DB::Status RocksdbDB::GetMetrics(std::map<std::string, double> *metrics) {
+  // the handle is shared with, and closed by, the client threads
+  const std::lock_guard<std::mutex> lock(mu_);
+  if (db_ == nullptr) {
+    return kError;
+  }
+  std::string value;
+  for (int level = 0; level < db_->NumberLevels(); level++) {
+    std::string name = rocksdb::DB::Properties::kNumFilesAtLevelPrefix + std::to_string(level);
+    if (db_->GetProperty(name, &value)) {
+      (*metrics)[name] = std::stod(value);
+    }
+  }
+  const std::string int_properties[] = {
+    rocksdb::DB::Properties::kEstimatePendingCompactionBytes,
+    rocksdb::DB::Properties::kNumRunningCompactions,
+    rocksdb::DB::Properties::kNumRunningFlushes,
+    rocksdb::DB::Properties::kCurSizeAllMemTables,
+    rocksdb::DB::Properties::kNumImmutableMemTable,
+    rocksdb::DB::Properties::kBlockCacheUsage,
+    rocksdb::DB::Properties::kBlockCachePinnedUsage,
+    rocksdb::DB::Properties::kTotalSstFilesSize,
+    rocksdb::DB::Properties::kEstimateNumKeys,
+    rocksdb::DB::Properties::kActualDelayedWriteRate,
+    rocksdb::DB::Properties::kIsWriteStopped,
+  };
+  for (const std::string &name : int_properties) {
+    uint64_t v;
+    if (db_->GetIntProperty(name, &v)) {
+      (*metrics)[name] = v;
+    }
+  }
+  return kOK;
+}
+
+DB::Status RocksdbDB::GetThreadMetrics(std::map<std::string, double> *metrics) {
+  // the perf context only counts once the thread asked for it
+  static thread_local bool counting = false;
+  if (!counting) {
+    if (rocksdb::GetPerfLevel() < rocksdb::PerfLevel::kEnableCount) {
+      rocksdb::SetPerfLevel(rocksdb::PerfLevel::kEnableCount);
+    }
+    counting = true;
+  }
+  const rocksdb::PerfContext *perf = rocksdb::get_perf_context();
+  (*metrics)["rocksdb.perf.internal_delete_skipped_count"] = perf->internal_delete_skipped_count;
+  (*metrics)["rocksdb.perf.internal_key_skipped_count"] = perf->internal_key_skipped_count;
+  return kOK;
 }
 
 void RocksdbDB::GetOptions(const utils::Properties &props, rocksdb::Options *opt,
@@ -431,7 +518,7 @@ DB::Status RocksdbDB::ReadSingle(const std::string &table, const std::string &ke
                                  const std::vector<std::string> *fields,
                                  std::vector<Field> &result) {
   std::string data;
-  rocksdb::Status s = db_->Get(rocksdb::ReadOptions(), key, &data);
+  rocksdb::Status s = db_->Get(SnapshotReadOptions(), key, &data);
   if (s.IsNotFound()) {
     return kNotFound;
   } else if (!s.ok()) {
@@ -449,8 +536,13 @@ DB::Status RocksdbDB::ReadSingle(const std::string &table, const std::string &ke
 DB::Status RocksdbDB::ScanSingle(const std::string &table, const std::string &key, int len,
                                  const std::vector<std::string> *fields,
                                  std::vector<std::vector<Field>> &result) {
-  rocksdb::Iterator *db_iter = db_->NewIterator(rocksdb::ReadOptions());
+  ScanProfile::Timer timer;
+  timer.Start();
+  rocksdb::Iterator *db_iter = db_->NewIterator(SnapshotReadOptions());
+  timer.Stop(ScanProfile::CREATE);
+  timer.Start();
   db_iter->Seek(key);
+  timer.Stop(ScanProfile::SEEK);
   for (int i = 0; db_iter->Valid() && i < len; i++) {
     std::string data = db_iter->value().ToString();
     result.push_back(std::vector<Field>());
@@ -461,7 +553,9 @@ DB::Status RocksdbDB::ScanSingle(const std::string &table, const std::string &ke
       DeserializeRow(values, data);
       assert(values.size() == static_cast<size_t>(fieldcount_));
     }
+    timer.Start();
     db_iter->Next();
+    timer.Stop(ScanProfile::NEXT);
   }
   delete db_iter;
   return kOK;
@@ -513,6 +607,62 @@ DB::Status RocksdbDB::MergeSingle(const std::string &table, const std::string &k
   return kOK;
 }
 
+DB::Status RocksdbDB::ReadModifyWriteSingle(const std::string &table, const std::string &key,
+                                            const std::vector<std::string> *fields,
+                                            std::vector<Field> &result, std::vector<Field> &values) {
+  ReadSingle(table, key, fields, result);
+  return UpdateSingle(table, key, values);
+}
+
+DB::Status RocksdbDB::ReadModifyWriteTransaction(const std::string &table, const std::string &key,
+                                                 const std::vector<std::string> *fields,
+                                                 std::vector<Field> &result,
+                                                 std::vector<Field> &values) {
+  // GetForUpdate makes the commit fail if another writer changed the record
+  // after it was read; the read and the write are retried together then
+  rocksdb::WriteOptions wopt;
+  std::unique_ptr<rocksdb::Transaction> txn;
+  while (true) {
+    txn.reset(txn_db_->BeginTransaction(wopt, rocksdb::OptimisticTransactionOptions(), txn.release()));
+    std::string data;
+    rocksdb::Status s = txn->GetForUpdate(rocksdb::ReadOptions(), key, &data);
+    if (s.IsNotFound()) {
+      return kNotFound;
+    } else if (!s.ok()) {
+      throw utils::Exception(std::string("RocksDB GetForUpdate: ") + s.ToString());
+    }
+    std::vector<Field> current_values;
+    DeserializeRow(current_values, data);
+    assert(current_values.size() == static_cast<size_t>(fieldcount_));
+    result.clear();
+    if (fields != nullptr) {
+      DeserializeRowFilter(result, data, *fields);
+    } else {
+      result = current_values;
+    }
+    for (Field &new_field : values) {
+      for (Field &cur_field : current_values) {
+        if (cur_field.name == new_field.name) {
+          cur_field.value = new_field.value;
+          break;
+        }
+      }
+    }
+    data.clear();
+    SerializeRow(current_values, data);
+    s = txn->Put(key, data);
+    if (!s.ok()) {
+      throw utils::Exception(std::string("RocksDB Transaction Put: ") + s.ToString());
+    }
+    s = txn->Commit();
+    if (s.ok()) {
+      return kOK;
+    } else if (!s.IsBusy() && !s.IsTryAgain()) {
+      throw utils::Exception(std::string("RocksDB Commit: ") + s.ToString());
+    }
+  }
+}
+
 DB::Status RocksdbDB::InsertSingle(const std::string &table, const std::string &key,
                                    std::vector<Field> &values) {
   std::string data;
@@ -8,6 +8,7 @@
 #ifndef YCSB_C_ROCKSDB_DB_H_
 #define YCSB_C_ROCKSDB_DB_H_
 
+#include <map>
 #include <string>
 #include <mutex>
 
@@ -16,6 +17,7 @@
 
 #include <rocksdb/db.h>
 #include <rocksdb/options.h>
+#include <rocksdb/utilities/optimistic_transaction_db.h>
 
 namespace ycsbc {
 
@@ -50,6 +52,19 @@ class RocksdbDB : public DB {
     return (this->*(method_delete_))(table, key);
   }
 
+  Status StartSnapshot();
+
+  Status ReleaseSnapshot();
+
+  Status GetMetrics(std::map<std::string, double> *metrics);
+  Status GetThreadMetrics(std::map<std::string, double> *metrics);
+
+  Status ReadModifyWrite(const std::string &table, const std::string &key,
+                         const std::vector<std::string> *fields, std::vector<Field> &result,
+                         std::vector<Field> &values) {
+    return (this->*(method_rmw_))(table, key, fields, result, values);
+  }
+
  private:
   enum RocksFormat {
     kSingleRow,
@@ -78,6 +93,12 @@ class RocksdbDB : public DB {
   Status InsertSingle(const std::string &table, const std::string &key,
                       std::vector<Field> &values);
   Status DeleteSingle(const std::string &table, const std::string &key);
+  Status ReadModifyWriteSingle(const std::string &table, const std::string &key,
+                               const std::vector<std::string> *fields, std::vector<Field> &result,
+                               std::vector<Field> &values);
+  Status ReadModifyWriteTransaction(const std::string &table, const std::string &key,
+                                    const std::vector<std::string> *fields,
+                                    std::vector<Field> &result, std::vector<Field> &values);
 
   Status (RocksdbDB::*method_read_)(const std::string &, const std:: string &,
                                     const std::vector<std::string> *, std::vector<Field> &);
@@ -89,11 +110,24 @@ class RocksdbDB : public DB {
   Status (RocksdbDB::*method_insert_)(const std::string &, const std::string &,
                                       std::vector<Field> &);
   Status (RocksdbDB::*method_delete_)(const std::string &, const std::string &);
+  Status (RocksdbDB::*method_rmw_)(const std::string &, const std::string &,
+                                   const std::vector<std::string> *, std::vector<Field> &,
+                                   std::vector<Field> &);
+
+  // reads and scans of this instance see snapshot_ while it is held
+  rocksdb::ReadOptions SnapshotReadOptions() const {
+    rocksdb::ReadOptions ropt;
+    ropt.snapshot = snapshot_;
+    return ropt;
+  }
 
   int fieldcount_;
+  const rocksdb::Snapshot *snapshot_{nullptr};
 
   static std::vector<rocksdb::ColumnFamilyHandle *> cf_handles_;
   static rocksdb::DB *db_;
+  // set when opened with rocksdb.rmw_transaction; db_ points to the same handle
+  static rocksdb::OptimisticTransactionDB *txn_db_;
   static int ref_cnt_;
   static std::mutex mu_;
 };
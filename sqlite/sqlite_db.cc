@@ -7,6 +7,7 @@
 
 #include "query_builder.h"
 #include "core/db_factory.h"
+#include "core/scan_profile.h"
 #include "utils/properties.h"
 #include "utils/utils.h"
 
@@ -136,19 +137,7 @@ void SqliteDB::PrepareQueries() {
       fields.push_back(field_prefix_ + std::to_string(i));
   }
 
-  // Read
-  stmt_read_all_ = SQLite3Prepare(db_, BuildReadQuery(table_name_, key_, fields));
-  for (size_t i = 0; i < field_count_; i++) {
-    std::string field_name = field_prefix_ + std::to_string(i);
-    stmt_read_field_[field_name] = SQLite3Prepare(db_, BuildReadQuery(table_name_, key_, {field_name}));
-  }
-
-  // Scan
-  stmt_scan_all_ = SQLite3Prepare(db_, BuildScanQuery(table_name_, key_, fields));
-  for (size_t i = 0; i < field_count_; i++) {
-    std::string field_name = field_prefix_ + std::to_string(i);
-    stmt_scan_field_[field_name] = SQLite3Prepare(db_, BuildScanQuery(table_name_, key_, {field_name}));
-  }
+  PrepareReadQueries(db_);
 
   // Update
   stmt_update_all_ = SQLite3Prepare(db_, BuildUpdateQuery(table_name_, key_, fields));
@@ -164,9 +153,29 @@ void SqliteDB::PrepareQueries() {
   stmt_delete_ = SQLite3Prepare(db_, BuildDeleteQuery(table_name_, key_));
 }
 
-void SqliteDB::Cleanup() {
-  const std::lock_guard<std::mutex> lock(mu_);
+void SqliteDB::PrepareReadQueries(sqlite3 *db) {
+  std::vector<std::string> fields;
+  fields.reserve(field_count_);
+  for (size_t i = 0; i < field_count_; i++) {
+      fields.push_back(field_prefix_ + std::to_string(i));
+  }
+
+  // Read
+  stmt_read_all_ = SQLite3Prepare(db, BuildReadQuery(table_name_, key_, fields));
+  for (size_t i = 0; i < field_count_; i++) {
+    std::string field_name = field_prefix_ + std::to_string(i);
+    stmt_read_field_[field_name] = SQLite3Prepare(db, BuildReadQuery(table_name_, key_, {field_name}));
+  }
+
+  // Scan
+  stmt_scan_all_ = SQLite3Prepare(db, BuildScanQuery(table_name_, key_, fields));
+  for (size_t i = 0; i < field_count_; i++) {
+    std::string field_name = field_prefix_ + std::to_string(i);
+    stmt_scan_field_[field_name] = SQLite3Prepare(db, BuildScanQuery(table_name_, key_, {field_name}));
+  }
+}
 
+void SqliteDB::FinalizeReadQueries() {
   sqlite3_finalize(stmt_read_all_);
   for (auto s : stmt_read_field_) {
     sqlite3_finalize(s.second);
@@ -175,6 +184,76 @@ void SqliteDB::Cleanup() {
   for (auto s : stmt_scan_field_) {
     sqlite3_finalize(s.second);
   }
+}
+
+DB::Status SqliteDB::StartSnapshot() {
+  if (snapshot_db_ != nullptr) {
+    return kOK;
+  }
+  // a transaction on the shared connection would cover all threads, so the
+  // snapshot lives on a private connection
+  const std::string &db_path = props_->GetProperty(PROP_DBPATH, PROP_DBPATH_DEFAULT);
+  int rc = sqlite3_open_v2(db_path.c_str(), &snapshot_db_, SQLITE_OPEN_READONLY, nullptr);
+  if (rc != SQLITE_OK) {
+    throw utils::Exception(std::string("Snapshot open: ") + sqlite3_errmsg(snapshot_db_));
+  }
+  // BEGIN is deferred, the first read takes the snapshot
+  rc = sqlite3_exec(snapshot_db_, "BEGIN; SELECT count(*) FROM sqlite_master;", nullptr, nullptr, nullptr);
+  if (rc != SQLITE_OK) {
+    throw utils::Exception(std::string("Snapshot begin: ") + sqlite3_errmsg(snapshot_db_));
+  }
+  FinalizeReadQueries();
+  PrepareReadQueries(snapshot_db_);
+  return kOK;
+}
+
+DB::Status SqliteDB::ReleaseSnapshot() {
+  if (snapshot_db_ == nullptr) {
+    return kOK;
+  }
+  FinalizeReadQueries();
+  int rc = sqlite3_exec(snapshot_db_, "COMMIT", nullptr, nullptr, nullptr);
+  if (rc != SQLITE_OK) {
+    throw utils::Exception(std::string("Snapshot commit: ") + sqlite3_errmsg(snapshot_db_));
+  }
+  sqlite3_close(snapshot_db_);
+  snapshot_db_ = nullptr;
+  PrepareReadQueries(db_);
+  return kOK;
+}
+
+DB::Status SqliteDB::GetMetrics(std::map<std::string, double> *metrics) {
+  // the handle is shared with, and closed by, the client threads
+  const std::lock_guard<std::mutex> lock(mu_);
+  if (db_ == nullptr) {
+    return kError;
+  }
+  const std::pair<const char *, int> db_status[] = {
+    {"sqlite.cache-used", SQLITE_DBSTATUS_CACHE_USED},
+    {"sqlite.cache-hit", SQLITE_DBSTATUS_CACHE_HIT},
+    {"sqlite.cache-miss", SQLITE_DBSTATUS_CACHE_MISS},
+    {"sqlite.cache-write", SQLITE_DBSTATUS_CACHE_WRITE},
+    {"sqlite.cache-spill", SQLITE_DBSTATUS_CACHE_SPILL},
+  };
+  for (auto &status : db_status) {
+    int current, highwater;
+    if (sqlite3_db_status(db_, status.second, &current, &highwater, 0) == SQLITE_OK) {
+      (*metrics)[status.first] = current;
+    }
+  }
+  (*metrics)["sqlite.memory-used"] = sqlite3_memory_used();
+  return kOK;
+}
+
+void SqliteDB::Cleanup() {
+  const std::lock_guard<std::mutex> lock(mu_);
+
+  FinalizeReadQueries();
+  if (snapshot_db_ != nullptr) {
+    // closing the connection ends its read transaction
+    sqlite3_close(snapshot_db_);
+    snapshot_db_ = nullptr;
+  }
   sqlite3_finalize(stmt_update_all_);
   for (auto s : stmt_update_field_) {
     sqlite3_finalize(s.second);
@@ -242,6 +321,7 @@ DB::Status SqliteDB::Scan(const std::string &table, const std::string &key, int
   bool temp = false;
   sqlite3_stmt *stmt;
   size_t field_cnt;
+  ScanProfile::Timer timer;
 
   if (fields == nullptr || fields->size() == field_count_) {
     field_cnt = field_count_;
@@ -266,8 +346,11 @@ DB::Status SqliteDB::Scan(const std::string &table, const std::string &key, int
     goto cleanup;
   }
 
+  // the statement is prepared once; the first step positions on the start key
   for (int i = 0; i < len; i++) {
+    timer.Start();
     rc = sqlite3_step(stmt);
+    timer.Stop(i == 0 ? ScanProfile::SEEK : ScanProfile::NEXT);
     if (rc != SQLITE_ROW) {
       break;
     }
@@ -8,6 +8,7 @@
 #ifndef YCSB_C_SQLITE_DB_H_
 #define YCSB_C_SQLITE_DB_H_
 
+#include <map>
 #include <mutex>
 #include <unordered_map>
 
@@ -38,10 +39,18 @@ class SqliteDB : public DB {
 
   Status Delete(const std::string &table, const std::string &key);
 
+  Status StartSnapshot();
+
+  Status ReleaseSnapshot();
+
+  Status GetMetrics(std::map<std::string, double> *metrics);
+
  private:
   void OpenDB();
   void SetPragma();
   void PrepareQueries();
+  void PrepareReadQueries(sqlite3 *db);
+  void FinalizeReadQueries();
 
   static sqlite3 *db_;
   static int ref_cnt_;
@@ -52,6 +61,9 @@ class SqliteDB : public DB {
   static size_t field_count_;
   static std::string table_name_;
 
+  // private read-only connection holding an open read transaction, if any
+  sqlite3 *snapshot_db_{nullptr};
+
   sqlite3_stmt *stmt_read_all_;
   sqlite3_stmt *stmt_scan_all_;
   sqlite3_stmt *stmt_update_all_;
@@ -19,11 +19,28 @@
 #include <iostream>
 #include <iomanip>  
 #include <atomic>
+#include <map>
+#include <sstream>
 
+#include "core/amplification_monitor.h"
 #include "core/client.h"
 #include "core/core_workload.h"
 #include "core/db_factory.h"
+#include "core/harness_profile.h"
+#include "core/latency_sampler.h"
 #include "core/measurements.h"
+#include "core/miss_ratio_curve.h"
+#include "core/payload_monitor.h"
+#include "core/perf_counters.h"
+#include "core/popularity_profile.h"
+#include "core/resource_monitor.h"
+#include "core/results_exporter.h"
+#include "core/scan_profile.h"
+#include "core/shm_metrics.h"
+#include "core/slow_op_log.h"
+#include "core/thread_measurements.h"
+#include "core/usdt.h"
+#include "core/working_set.h"
 #include "utils/countdown_latch.h"
 #include "utils/rate_limit.h"
 #include "utils/timer.h"
@@ -32,7 +49,7 @@
 using namespace std;
 ////statistics
 atomic<uint64_t> ops_cnt[ycsbc::Operation::READMODIFYWRITE + 1];    //操作个数
-atomic<uint64_t> ops_time[ycsbc::Operation::READMODIFYWRITE + 1];   //微秒
+atomic<uint64_t> ops_time[ycsbc::Operation::READMODIFYWRITE + 1];   //纳秒
 ////
 
 void UsageMessage(const char *command);
@@ -40,20 +57,86 @@ bool StrStartWith(const char *str, const char *pre);
 void ParseCommandLine(int argc, const char *argv[], ycsbc::utils::Properties &props);
 void PrintInfo(ycsbc::utils::Properties &props);
 void Init(ycsbc::utils::Properties &props);
-
-void StatusThread(ycsbc::Measurements *measurements, ycsbc::utils::CountDownLatch *latch, int interval) {
+void PrintMissRatioCurve(ycsbc::utils::Properties &props);
+
+// metrics_db, if set, is sampled for engine statistics every interval. The
+// interval's resource usage and, if export_db_metrics, engine statistics are
+// added to the time series of phase in exporter, if set. Every interval is
+// also published to shm, if set. working_set, if set, is drained into a new
+// interval every tick.
+void StatusThread(ycsbc::PerThreadMeasurements *measurements, ycsbc::ResourceMonitor *resources,
+                  ycsbc::WorkingSet *working_set, ycsbc::DB *metrics_db,
+                  ycsbc::ResultsExporter *exporter, bool export_db_metrics, std::string phase,
+                  ycsbc::ShmMetricsWriter *shm, ycsbc::utils::CountDownLatch *latch,
+                  std::chrono::milliseconds interval, bool print) {
   using namespace std::chrono;
   time_point<system_clock> start = system_clock::now();
   bool done = false;
   while (1) {
+    measurements->FinishInterval();
+    resources->FinishInterval(measurements->Operations());
+    if (working_set) {
+      working_set->FinishInterval();
+    }
+
     time_point<system_clock> now = system_clock::now();
-    std::time_t now_c = system_clock::to_time_t(now);
     duration<double> elapsed_time = now - start;
+    YCSB_PROBE3(status__tick, phase.c_str(), static_cast<uint64_t>(elapsed_time.count() * 1000),
+                measurements->Operations());
+    std::map<std::string, double> db_metrics;
+    // main closes the DBs only after the status thread has finished
+    if (metrics_db) {
+      try {
+        if (metrics_db->GetMetrics(&db_metrics) != ycsbc::DB::kOK) {
+          db_metrics.clear();
+        }
+      } catch (const ycsbc::utils::Exception &e) {
+        std::cerr << "Caught exception:" << e.what() << std::endl;
+        metrics_db = nullptr;
+      }
+    }
+    if (exporter) {
+      std::map<std::string, double> sample;
+      if (export_db_metrics) {
+        sample = db_metrics;
+      }
+      resources->AddIntervalMetrics(&sample);
+      if (!sample.empty()) {
+        exporter->AddSample(phase, elapsed_time.count(), sample);
+      }
+    }
+    if (shm) {
+      shm->Publish(measurements, measurements->Operations(), db_metrics);
+    }
 
-    std::cout << std::put_time(std::localtime(&now_c), "%F %T") << ' '
-              << static_cast<long long>(elapsed_time.count()) << " sec: ";
+    if (print) {
+      std::time_t now_c = system_clock::to_time_t(now);
+
+      std::ostringstream elapsed_stream;
+      if (interval.count() % 1000 == 0) {
+        elapsed_stream << static_cast<long long>(elapsed_time.count());
+      } else {
+        elapsed_stream << std::fixed << std::setprecision(3) << elapsed_time.count();
+      }
+      std::cout << std::put_time(std::localtime(&now_c), "%F %T") << ' ' << elapsed_stream.str() << " sec: ";
 
-    std::cout << measurements->GetStatusMsg() << std::endl;
+      std::cout << measurements->GetStatusMsg() << std::endl;
+      std::cout << measurements->GetIntervalStatusMsg() << std::endl;
+      std::cout << resources->GetIntervalStatusMsg() << std::endl;
+      if (working_set) {
+        std::cout << working_set->GetIntervalStatusMsg() << std::endl;
+      }
+      if (!db_metrics.empty()) {
+        std::ostringstream msg_stream;
+        msg_stream.precision(15);
+        msg_stream << " [DB:";
+        for (auto &metric : db_metrics) {
+          msg_stream << " " << metric.first << "=" << metric.second;
+        }
+        msg_stream << "]";
+        std::cout << msg_stream.str() << std::endl;
+      }
+    }
 
     if (done) {
       break;
@@ -103,13 +186,21 @@ int main(const int argc, const char *argv[]) {
 
   const bool do_load = (props.GetProperty("doload", "false") == "true");
   const bool do_transaction = (props.GetProperty("dotransaction", "false") == "true");
+  const bool do_mrc = (props.GetProperty("domrc", "false") == "true");
   // const bool wait_for_balance = ycsbc::utils::StrToBool(props["dbwaitforbalance"]);
 
-  if (!do_load && !do_transaction) {
+  if (!do_load && !do_transaction && !do_mrc) {
     std::cerr << "No operation to do" << std::endl;
     exit(1);
   }
 
+  if (do_mrc) {
+    PrintMissRatioCurve(props);
+    if (!do_load && !do_transaction) {
+      return 0;
+    }
+  }
+
   const int num_threads = stoi(props.GetProperty("threadcount", "1"));
 
   //测试延迟相关
@@ -118,11 +209,67 @@ int main(const int argc, const char *argv[]) {
     std::cerr << "Unknown measurements name" << std::endl;
     exit(1);
   }
+  // op counts (and latencies) per client thread, owns the measurements
+  ycsbc::PerThreadMeasurements *thread_measurements =
+      new ycsbc::PerThreadMeasurements(&props, measurements, num_threads);
+  measurements = thread_measurements;
+
+  // generation / engine / recording breakdown of every operation
+  ycsbc::HarnessProfile *harness = nullptr;
+  if (ycsbc::utils::StrToBool(props.GetProperty(ycsbc::HarnessProfile::ENABLED_PROPERTY,
+                                                ycsbc::HarnessProfile::ENABLED_DEFAULT))) {
+    harness = new ycsbc::HarnessProfile(&props);
+  }
+  // hardware counters of the engine calls
+  ycsbc::PerfCounters *perf = nullptr;
+  if (ycsbc::utils::StrToBool(props.GetProperty(ycsbc::PerfCounters::ENABLED_PROPERTY,
+                                                ycsbc::PerfCounters::ENABLED_DEFAULT))) {
+    perf = new ycsbc::PerfCounters(num_threads);
+  }
+  // latency by zipfian popularity rank of the key
+  ycsbc::PopularityProfile *popularity = nullptr;
+  if (ycsbc::utils::StrToBool(props.GetProperty(ycsbc::PopularityProfile::ENABLED_PROPERTY,
+                                                ycsbc::PopularityProfile::ENABLED_DEFAULT))) {
+    popularity = new ycsbc::PopularityProfile(&props);
+  }
+  // iterator creation, seek and next latencies of the bindings' scans
+  ycsbc::ScanProfile *scan_profile = nullptr;
+  if (ycsbc::utils::StrToBool(props.GetProperty(ycsbc::ScanProfile::ENABLED_PROPERTY,
+                                                ycsbc::ScanProfile::ENABLED_DEFAULT))) {
+    scan_profile = new ycsbc::ScanProfile(&props);
+  }
+  // operations above slowop.threshold_us with their keys
+  ycsbc::SlowOpLog *slow_ops = nullptr;
+  if (std::stoull(props.GetProperty(ycsbc::SlowOpLog::THRESHOLD_PROPERTY,
+                                    ycsbc::SlowOpLog::THRESHOLD_DEFAULT)) > 0) {
+    slow_ops = new ycsbc::SlowOpLog(&props, num_threads);
+  }
+  // a bounded random sample of the raw latencies
+  ycsbc::LatencySampler *samples = nullptr;
+  if (props.GetProperty(ycsbc::LatencySampler::FILE_PROPERTY, ycsbc::LatencySampler::FILE_DEFAULT) != "") {
+    samples = new ycsbc::LatencySampler(&props, num_threads);
+  }
+  // distinct keys per status interval and per phase
+  ycsbc::WorkingSet *working_set = nullptr;
+  if (ycsbc::utils::StrToBool(props.GetProperty(ycsbc::WorkingSet::ENABLED_PROPERTY,
+                                                ycsbc::WorkingSet::ENABLED_DEFAULT))) {
+    working_set = new ycsbc::WorkingSet(&props, num_threads);
+  }
+
+  // request and response bytes per operation type
+  ycsbc::PayloadMonitor payload(num_threads);
+  // logical vs. physical bytes written and stored per phase
+  ycsbc::AmplificationMonitor amplification(&props, &payload, do_load);
 
   //创建数据库
   std::vector<ycsbc::DB *> dbs;
   for (int i = 0; i < num_threads; i++) {
-    ycsbc::DB *db = ycsbc::DBFactory::CreateDB(&props, measurements);
+    ycsbc::DB *db = ycsbc::DBFactory::CreateDB(&props, thread_measurements->ForThread(i), harness,
+                                               perf ? perf->ForThread(i) : nullptr,
+                                               slow_ops ? slow_ops->ForThread(i) : nullptr,
+                                               payload.ForThread(i), popularity,
+                                               working_set ? working_set->ForThread(i) : nullptr,
+                                               samples ? samples->ForThread(i) : nullptr);
     if (db == nullptr) {
       std::cerr << "Unknown database name " << props["dbname"] << std::endl;
       exit(1);
@@ -130,28 +277,92 @@ int main(const int argc, const char *argv[]) {
     dbs.push_back(db);
   }
 
-  ycsbc::CoreWorkload wl;
-  wl.Init(props);
+  ycsbc::CoreWorkload *wl = ycsbc::CreateWorkload(props);
+  if (wl == nullptr) {
+    std::cerr << "Unknown workload " << props.GetProperty(ycsbc::CoreWorkload::WORKLOAD_PROPERTY)
+              << std::endl;
+    exit(1);
+  }
+  try {
+    wl->Init(props);
+  } catch (const ycsbc::utils::Exception &e) {
+    std::cerr << "Caught exception:" << e.what() << std::endl;
+    exit(1);
+  }
 
   // print status periodically
   const bool show_status = (props.GetProperty("status", "false") == "true");
-  const int status_interval = std::stoi(props.GetProperty("status.interval", "1800"));
+  // sample engine statistics (DB::GetMetrics) every status interval into the results
+  const bool sample_db_metrics = ycsbc::utils::StrToBool(props.GetProperty("status.dbmetrics", "false"));
+  // live metrics in shared memory for ycsb-top
+  const std::string shm_name = props.GetProperty(ycsbc::ShmMetricsWriter::NAME_PROPERTY,
+                                                 ycsbc::ShmMetricsWriter::NAME_DEFAULT);
+  ycsbc::ShmMetricsWriter *shm = nullptr;
+  if (shm_name != "") {
+#ifdef YCSB_C_HAVE_SHM
+    try {
+      shm = new ycsbc::ShmMetricsWriter(shm_name, props["dbname"]);
+    } catch (const ycsbc::utils::Exception &e) {
+      std::cerr << "Caught exception:" << e.what() << std::endl;
+      exit(1);
+    }
+#else
+    std::cerr << ycsbc::ShmMetricsWriter::NAME_PROPERTY << " is not supported on this platform" << std::endl;
+    exit(1);
+#endif
+  }
+  // machine-readable results, written once both phases are done
+  const std::string export_path = props.GetProperty("export", "");
+  ycsbc::ResultsExporter *exporter = nullptr;
+  if (export_path != "") {
+    exporter = new ycsbc::ResultsExporter(props);
+  }
+
+  // the status thread also closes the intervals of the histogram log and
+  // samples the resource usage for the exported time series
+  const bool status_thread = show_status || sample_db_metrics || shm || exporter ||
+                             props.GetProperty("measurement.histogram.log", "") != "";
+  // status.interval_ms allows sub-second ticks and takes precedence over status.interval,
+  // which defaults to the shm publish interval if shm.name is set
+  std::chrono::milliseconds status_interval(std::stoi(props.GetProperty("status.interval_ms", "0")));
+  if (status_interval.count() <= 0 && shm && !props.ContainsKey("status.interval")) {
+    status_interval = std::chrono::milliseconds(std::stoi(
+        props.GetProperty(ycsbc::ShmMetricsWriter::INTERVAL_PROPERTY, ycsbc::ShmMetricsWriter::INTERVAL_DEFAULT)));
+  }
+  if (status_interval.count() <= 0) {
+    status_interval = std::chrono::seconds(std::stoi(props.GetProperty("status.interval", "1800")));
+  }
   const bool print_stats = (props.GetProperty("dbstatistics","false") == "true");
 
+  // cpu, memory and i/o of the process, sampled with the status and per phase
+  ycsbc::ResourceMonitor resources(props["dbpath"]);
+
   // load phase
   if (do_load) {
     const int total_ops = stoi(props[ycsbc::CoreWorkload::RECORD_COUNT_PROPERTY]);
 
     ycsbc::utils::CountDownLatch latch(num_threads);
-    ycsbc::utils::Timer<uint64_t, std::micro> timer;
-
+    ycsbc::utils::NanoTimer timer;
+
+    measurements->StartPhase("load");
+    resources.StartPhase();
+    payload.StartPhase();
+    amplification.StartPhase();
+    if (shm) {
+      shm->StartPhase("load");
+    }
     std::future<void> status_future;
-    if (show_status) {
+    if (status_thread) {
       status_future = std::async(std::launch::async, StatusThread,
-                                 measurements, &latch, status_interval);
+                                 thread_measurements, &resources, working_set,
+                                 sample_db_metrics || shm ? dbs[0] : nullptr,
+                                 exporter, sample_db_metrics, "load", shm,
+                                 &latch, status_interval, show_status);
     }
 
     std::vector<std::future<int>> client_threads;
+    std::vector<double> thread_runtime(num_threads);
+    YCSB_PROBE1(phase__start, "load");
     timer.Start();
     for (int i = 0; i < num_threads; ++i) {
       int thread_ops = total_ops / num_threads;
@@ -159,8 +370,9 @@ int main(const int argc, const char *argv[]) {
         thread_ops++;
       }
 
-      client_threads.emplace_back(std::async(std::launch::async, ycsbc::ClientThread, dbs[i], &wl,
-                                             thread_ops, true, true, !do_transaction, &latch, nullptr));
+      client_threads.emplace_back(std::async(std::launch::async, ycsbc::ClientThread, dbs[i], wl, i,
+                                             thread_ops, true, true, &latch, nullptr,
+                                             harness, &thread_runtime[i], thread_measurements, nullptr));
     }
     assert((int)client_threads.size() == num_threads);
 
@@ -171,9 +383,14 @@ int main(const int argc, const char *argv[]) {
     }
     // uint64_t runtime_timer = timer.End();
     uint64_t runtime = timer.End();
-    if (show_status) {
+    resources.FinishPhase();
+    YCSB_PROBE3(phase__end, "load", static_cast<uint64_t>(sum), runtime / 1000);
+    if (status_thread) {
       status_future.wait();
     }
+    if (shm) {
+      shm->FinishPhase();
+    }
 
     // uint64_t temp_cnt = ops_cnt[ycsbc::INSERT].load(std::memory_order_relaxed);
     // uint64_t temp_time = ops_time[ycsbc::INSERT].load(std::memory_order_relaxed);
@@ -184,13 +401,69 @@ int main(const int argc, const char *argv[]) {
 
     std::cout << "********** load result **********" << std::endl;
     std::cout << "loading records: " << sum << std::endl
-              << "use time: " << std::fixed << std::setprecision(3) << 1.0 * runtime * 1e-6 << " s" 
+              << "use time: " << std::fixed << std::setprecision(3) << 1.0 * runtime * 1e-9 << " s" 
               << std::endl
-              << "IOPS: " << std::fixed << std::setprecision(2) << (1.0 * sum * 1e6 / runtime) 
-              << "iops: " << std::fixed << std::setprecision(2) << (1.0 * runtime / sum) << " (us/op)"
+              << "IOPS: " << std::fixed << std::setprecision(2) << (1.0 * sum * 1e9 / runtime) 
+              << "iops: " << std::fixed << std::setprecision(2) << (1e-3 * runtime / sum) << " (us/op)"
               <<std::endl;
     std::cout << "*********************************" << std::endl;
 
+    if (exporter) {
+      exporter->AddPhase("load", 1.0 * runtime * 1e-9, sum, measurements);
+    }
+    thread_measurements->Print(thread_runtime);
+    if (exporter) {
+      thread_measurements->Export(exporter, "load", thread_runtime);
+    }
+    resources.Print(sum);
+    if (exporter) {
+      resources.Export(exporter, "load", sum);
+    }
+    payload.Print(1.0 * runtime * 1e-9, measurements);
+    if (exporter) {
+      payload.Export(exporter, "load", 1.0 * runtime * 1e-9, measurements);
+    }
+    amplification.Print();
+    if (exporter) {
+      amplification.Export(exporter, "load");
+    }
+    if (harness) {
+      harness->Print();
+      if (exporter) {
+        harness->Export(exporter, "load");
+      }
+    }
+    if (perf) {
+      perf->Print();
+      if (exporter) {
+        perf->Export(exporter, "load");
+      }
+    }
+    if (popularity) {
+      popularity->Print();
+      if (exporter) {
+        popularity->Export(exporter, "load");
+      }
+    }
+    if (scan_profile) {
+      scan_profile->Print();
+      if (exporter) {
+        scan_profile->Export(exporter, "load");
+      }
+    }
+    if (working_set) {
+      working_set->Print();
+      if (exporter) {
+        working_set->Export(exporter, "load");
+      }
+    }
+    if (slow_ops) {
+      slow_ops->Dump("load");
+    }
+    if (samples) {
+      samples->Dump("load");
+    }
+
     // printf("********** load result **********\n");
     //     printf("loading records:%d  use time:%.3f s  IOPS:%.2f iops (%.2f us/op)\n", sum, 1.0 * use_time*1e-6, 1.0 * sum * 1e6 / use_time, 1.0 * use_time / sum);
     // printf("*********************************\n");
@@ -219,11 +492,31 @@ int main(const int argc, const char *argv[]) {
     {
       std::cerr << "Caught exception:" << e.what() << std::endl;
     }
-    
 
+    // not in the client threads, the status thread may still sample the engine
+    if (!do_transaction) {
+      for (ycsbc::DB *db : dbs) {
+        db->Cleanup();
+      }
+    }
   }
 
   measurements->Reset();
+  if (harness) {
+    harness->Reset();
+  }
+  if (perf) {
+    perf->Reset();
+  }
+  if (popularity) {
+    popularity->Reset();
+  }
+  if (scan_profile) {
+    scan_profile->Reset();
+  }
+  if (working_set) {
+    working_set->Reset();
+  }
   std::this_thread::sleep_for(std::chrono::seconds(stoi(props.GetProperty("sleepafterload", "0"))));
 
 
@@ -237,26 +530,50 @@ int main(const int argc, const char *argv[]) {
     const int total_ops = stoi(props[ycsbc::CoreWorkload::OPERATION_COUNT_PROPERTY]);
 
     ycsbc::utils::CountDownLatch latch(num_threads);
-    ycsbc::utils::Timer<uint64_t, std::micro> timer;
+    ycsbc::utils::NanoTimer timer;
 
     for(int j = 0; j < ycsbc::Operation::READMODIFYWRITE + 1; j++){
       ops_cnt[j].store(0);
       ops_time[j].store(0);
     }
 
+    measurements->StartPhase("run");
+    resources.StartPhase();
+    payload.StartPhase();
+    amplification.StartPhase();
+    if (shm) {
+      shm->StartPhase("run");
+    }
     std::future<void> status_future;
-    if (show_status) {
+    if (status_thread) {
       status_future = std::async(std::launch::async, StatusThread,
-                                 measurements, &latch, status_interval);
+                                 thread_measurements, &resources, working_set,
+                                 sample_db_metrics || shm ? dbs[0] : nullptr,
+                                 exporter, sample_db_metrics, "run", shm,
+                                 &latch, status_interval, show_status);
     }
     std::vector<std::future<int>> client_threads;
+    std::vector<double> thread_runtime(num_threads);
     std::vector<ycsbc::utils::RateLimiter *> rate_limiters;
 
-    timer.Start();
+    // background threads (snapshot readers) run until the others are done and
+    // are left out of the run result
+    std::vector<bool> background(num_threads);
+    int num_foreground = 0;
     for (int i = 0; i < num_threads; ++i) {
-      int thread_ops = total_ops / num_threads;
-      if (i < total_ops % num_threads) {
-        thread_ops++;
+      background[i] = wl->IsBackgroundThread(i);
+      thread_measurements->SetBackground(i, background[i]);
+      num_foreground += background[i] ? 0 : 1;
+    }
+    std::atomic<bool> foreground_done(false);
+
+    YCSB_PROBE1(phase__start, "run");
+    timer.Start();
+    for (int i = 0, j = 0; i < num_threads; ++i) {
+      int thread_ops = 0;
+      if (!background[i]) {
+        thread_ops = total_ops / num_foreground + (j < total_ops % num_foreground ? 1 : 0);
+        j++;
       }
       ycsbc::utils::RateLimiter *rlim = nullptr;
       if (ops_limit > 0 || rate_file != "") {
@@ -264,8 +581,10 @@ int main(const int argc, const char *argv[]) {
         rlim = new ycsbc::utils::RateLimiter(per_thread_ops, per_thread_ops);
       }
       rate_limiters.push_back(rlim);
-      client_threads.emplace_back(std::async(std::launch::async, ycsbc::ClientThread, dbs[i], &wl,
-                                             thread_ops, false, !do_load, true, &latch, rlim));
+      client_threads.emplace_back(std::async(std::launch::async, ycsbc::ClientThread, dbs[i], wl, i,
+                                             thread_ops, false, !do_load, &latch, rlim, harness,
+                                             &thread_runtime[i], thread_measurements,
+                                             background[i] ? &foreground_done : nullptr));
     }
 
     std::future<void> rlim_future;
@@ -276,15 +595,28 @@ int main(const int argc, const char *argv[]) {
     assert((int)client_threads.size() == num_threads);
 
     int sum = 0;
-    for (auto &n : client_threads) {
-      assert(n.valid());
-      sum += n.get();
+    for (int i = 0; i < num_threads; ++i) {
+      assert(client_threads[i].valid());
+      if (!background[i]) {
+        sum += client_threads[i].get();
+      }
     }
     uint64_t runtime = timer.End();
+    resources.FinishPhase();
+    foreground_done = true;
+    for (int i = 0; i < num_threads; ++i) {
+      if (background[i]) {
+        client_threads[i].get();
+      }
+    }
+    YCSB_PROBE3(phase__end, "run", static_cast<uint64_t>(sum), runtime / 1000);
 
-    if (show_status) {
+    if (status_thread) {
       status_future.wait();
     }
+    if (shm) {
+      shm->FinishPhase();
+    }
 
     uint64_t temp_cnt[ycsbc::Operation::READMODIFYWRITE + 1];
     uint64_t temp_time[ycsbc::Operation::READMODIFYWRITE + 1];
@@ -303,65 +635,123 @@ int main(const int argc, const char *argv[]) {
 
     std::cout << "********** run result **********" << std::endl;
     std::cout << "all operation records: " << sum << std::endl
-              << "use time: " << std::fixed << std::setprecision(3) << 1.0 * runtime * 1e-6 << " s" 
+              << "use time: " << std::fixed << std::setprecision(3) << 1.0 * runtime * 1e-9 << " s" 
               << std::endl
-              << "IOPS: " << std::fixed << std::setprecision(2) << 1.0 * sum * 1e6 / runtime 
+              << "IOPS: " << std::fixed << std::setprecision(2) << 1.0 * sum * 1e9 / runtime 
               << std::endl
-              << "iops: " << std::fixed << std::setprecision(2) << 1.0 * runtime / sum << " (us/op)" 
+              << "iops: " << std::fixed << std::setprecision(2) << 1e-3 * runtime / sum << " (us/op)" 
               << std::endl;
 
     if (temp_cnt[ycsbc::INSERT])
         std::cout << "insert ops: " << temp_cnt[ycsbc::INSERT] 
                   << std::endl
-                  << "use time: " << std::fixed << std::setprecision(3) << 1.0 * temp_time[ycsbc::INSERT] * 1e-6 << " s"
+                  << "use time: " << std::fixed << std::setprecision(3) << 1.0 * temp_time[ycsbc::INSERT] * 1e-9 << " s"
                   << std::endl
-                  << "IOPS: " << std::fixed << std::setprecision(2) << 1.0 * temp_cnt[ycsbc::INSERT] * 1e6 / temp_time[ycsbc::INSERT]
+                  << "IOPS: " << std::fixed << std::setprecision(2) << 1.0 * temp_cnt[ycsbc::INSERT] * 1e9 / temp_time[ycsbc::INSERT]
                   << std::endl
-                  << "iops " << std::fixed << std::setprecision(2) << 1.0 * temp_time[ycsbc::INSERT] / temp_cnt[ycsbc::INSERT] << " (us/op)" 
+                  << "iops " << std::fixed << std::setprecision(2) << 1e-3 * temp_time[ycsbc::INSERT] / temp_cnt[ycsbc::INSERT] << " (us/op)" 
                   << std::endl;
 
     if (temp_cnt[ycsbc::READ])
         std::cout << "read ops: " << temp_cnt[ycsbc::READ] 
                   << std::endl
-                  << "use time: " << std::fixed << std::setprecision(3) << 1.0 * temp_time[ycsbc::READ] * 1e-6 << " s"
+                  << "use time: " << std::fixed << std::setprecision(3) << 1.0 * temp_time[ycsbc::READ] * 1e-9 << " s"
                   << std::endl
-                  << "IOPS: " << std::fixed << std::setprecision(2) << 1.0 * temp_cnt[ycsbc::READ] * 1e6 / temp_time[ycsbc::READ]
+                  << "IOPS: " << std::fixed << std::setprecision(2) << 1.0 * temp_cnt[ycsbc::READ] * 1e9 / temp_time[ycsbc::READ]
                   << std::endl
-                  << "iops " << std::fixed << std::setprecision(2) << 1.0 * temp_time[ycsbc::READ] / temp_cnt[ycsbc::READ] << " (us/op)" 
+                  << "iops " << std::fixed << std::setprecision(2) << 1e-3 * temp_time[ycsbc::READ] / temp_cnt[ycsbc::READ] << " (us/op)" 
                   << std::endl;
 
     if (temp_cnt[ycsbc::UPDATE])
         std::cout << "update ops: " << temp_cnt[ycsbc::UPDATE] 
                   << std::endl
-                  << "use time: " << std::fixed << std::setprecision(3) << 1.0 * temp_time[ycsbc::UPDATE] * 1e-6 << " s"
+                  << "use time: " << std::fixed << std::setprecision(3) << 1.0 * temp_time[ycsbc::UPDATE] * 1e-9 << " s"
                   << std::endl
-                  << "IOPS: " << std::fixed << std::setprecision(2) << 1.0 * temp_cnt[ycsbc::UPDATE] * 1e6 / temp_time[ycsbc::UPDATE]
+                  << "IOPS: " << std::fixed << std::setprecision(2) << 1.0 * temp_cnt[ycsbc::UPDATE] * 1e9 / temp_time[ycsbc::UPDATE]
                   << std::endl
-                  << "iops " << std::fixed << std::setprecision(2) << 1.0 * temp_time[ycsbc::UPDATE] / temp_cnt[ycsbc::UPDATE] << " (us/op)" 
+                  << "iops " << std::fixed << std::setprecision(2) << 1e-3 * temp_time[ycsbc::UPDATE] / temp_cnt[ycsbc::UPDATE] << " (us/op)" 
                   << std::endl;
 
     if (temp_cnt[ycsbc::SCAN])
         std::cout << "scan ops: " << temp_cnt[ycsbc::SCAN] 
                   << std::endl
-                  << "use time: " << std::fixed << std::setprecision(3) << 1.0 * temp_time[ycsbc::SCAN] * 1e-6 << " s"
+                  << "use time: " << std::fixed << std::setprecision(3) << 1.0 * temp_time[ycsbc::SCAN] * 1e-9 << " s"
                   << std::endl
-                  << "IOPS: " << std::fixed << std::setprecision(2) << 1.0 * temp_cnt[ycsbc::SCAN] * 1e6 / temp_time[ycsbc::SCAN]
+                  << "IOPS: " << std::fixed << std::setprecision(2) << 1.0 * temp_cnt[ycsbc::SCAN] * 1e9 / temp_time[ycsbc::SCAN]
                   << std::endl
-                  << "iops " << std::fixed << std::setprecision(2) << 1.0 * temp_time[ycsbc::SCAN] / temp_cnt[ycsbc::SCAN] << " (us/op)" 
+                  << "iops " << std::fixed << std::setprecision(2) << 1e-3 * temp_time[ycsbc::SCAN] / temp_cnt[ycsbc::SCAN] << " (us/op)" 
                   << std::endl;
 
     if (temp_cnt[ycsbc::READMODIFYWRITE])
         std::cout << "rmw ops: " << temp_cnt[ycsbc::READMODIFYWRITE] 
                   << std::endl
-                  << "use time: " << std::fixed << std::setprecision(3) << 1.0 * temp_time[ycsbc::READMODIFYWRITE] * 1e-6 << " s"
+                  << "use time: " << std::fixed << std::setprecision(3) << 1.0 * temp_time[ycsbc::READMODIFYWRITE] * 1e-9 << " s"
                   << std::endl
-                  << "IOPS: " << std::fixed << std::setprecision(2) << 1.0 * temp_cnt[ycsbc::READMODIFYWRITE] * 1e6 / temp_time[ycsbc::READMODIFYWRITE]
+                  << "IOPS: " << std::fixed << std::setprecision(2) << 1.0 * temp_cnt[ycsbc::READMODIFYWRITE] * 1e9 / temp_time[ycsbc::READMODIFYWRITE]
                   << std::endl
-                  << "iops " << std::fixed << std::setprecision(2) << 1.0 * temp_time[ycsbc::READMODIFYWRITE] / temp_cnt[ycsbc::READMODIFYWRITE] << " (us/op)" 
+                  << "iops " << std::fixed << std::setprecision(2) << 1e-3 * temp_time[ycsbc::READMODIFYWRITE] / temp_cnt[ycsbc::READMODIFYWRITE] << " (us/op)" 
                   << std::endl;
 
     std::cout << "********************************" << std::endl;
 
+    if (exporter) {
+      exporter->AddPhase("run", 1.0 * runtime * 1e-9, sum, measurements);
+    }
+    thread_measurements->Print(thread_runtime);
+    if (exporter) {
+      thread_measurements->Export(exporter, "run", thread_runtime);
+    }
+    resources.Print(sum);
+    if (exporter) {
+      resources.Export(exporter, "run", sum);
+    }
+    payload.Print(1.0 * runtime * 1e-9, measurements);
+    if (exporter) {
+      payload.Export(exporter, "run", 1.0 * runtime * 1e-9, measurements);
+    }
+    amplification.Print();
+    if (exporter) {
+      amplification.Export(exporter, "run");
+    }
+    if (harness) {
+      harness->Print();
+      if (exporter) {
+        harness->Export(exporter, "run");
+      }
+    }
+    if (perf) {
+      perf->Print();
+      if (exporter) {
+        perf->Export(exporter, "run");
+      }
+    }
+    if (popularity) {
+      popularity->Print();
+      if (exporter) {
+        popularity->Export(exporter, "run");
+      }
+    }
+    if (scan_profile) {
+      scan_profile->Print();
+      if (exporter) {
+        scan_profile->Export(exporter, "run");
+      }
+    }
+    if (working_set) {
+      working_set->Print();
+      if (exporter) {
+        working_set->Export(exporter, "run");
+      }
+    }
+    if (slow_ops) {
+      slow_ops->Dump("run");
+    }
+    if (samples) {
+      samples->Dump("run");
+    }
+
+    wl->PrintStats();
+
     
     // printf("********** run result **********\n");
     // printf("all opeartion records:%d  use time:%.3f s  IOPS:%.2f iops (%.2f us/op)\n\n", sum, 1.0 * use_time*1e-6, 1.0 * sum * 1e6 / use_time, 1.0 * use_time / sum);
@@ -399,6 +789,9 @@ int main(const int argc, const char *argv[]) {
       std::cerr << "Caught exception:" << e.what() << std::endl;
     }
 
+    for (ycsbc::DB *db : dbs) {
+      db->Cleanup();
+    }
   }
 
   // if (wait_for_balance) {
@@ -414,9 +807,29 @@ int main(const int argc, const char *argv[]) {
   //   printf("-------------------------------------------\n");
   // }
 
+  if (exporter) {
+    try {
+      exporter->Write(export_path);
+      std::cout << "results exported to " << export_path << std::endl;
+    } catch (const ycsbc::utils::Exception &e) {
+      std::cerr << "Caught exception:" << e.what() << std::endl;
+    }
+    delete exporter;
+  }
+
   for (int i = 0; i < num_threads; i++) {
     delete dbs[i];
   }
+  delete wl;
+  delete harness;
+  delete perf;
+  delete slow_ops;
+  delete samples;
+  delete popularity;
+  delete scan_profile;
+  delete working_set;
+  delete shm;
+  delete measurements;
 }
 
 void ParseCommandLine(int argc, const char *argv[], ycsbc::utils::Properties &props) {
@@ -428,6 +841,9 @@ void ParseCommandLine(int argc, const char *argv[], ycsbc::utils::Properties &pr
     } else if (strcmp(argv[argindex], "-run") == 0 || strcmp(argv[argindex], "-t") == 0) {
       props.SetProperty("dotransaction", "true");
       argindex++;
+    } else if (strcmp(argv[argindex], "-mrc") == 0) {
+      props.SetProperty("domrc", "true");
+      argindex++;
     } else if (strcmp(argv[argindex], "-threads") == 0) {
       argindex++;
       if (argindex >= argc) {
@@ -495,6 +911,15 @@ void ParseCommandLine(int argc, const char *argv[], ycsbc::utils::Properties &pr
     } else if (strcmp(argv[argindex], "-dbstatistics") == 0) {
       props.SetProperty("dbstatistics", "true");
       argindex++;
+    } else if (strcmp(argv[argindex], "-export") == 0) {
+      argindex++;
+      if (argindex >= argc) {
+        UsageMessage(argv[0]);
+        std::cerr << "Missing argument value for -export" << std::endl;
+        exit(0);
+      }
+      props.SetProperty("export", argv[argindex]);
+      argindex++;
     }else {
       UsageMessage(argv[0]);
       std::cerr << "Unknown option '" << argv[argindex] << "'" << std::endl;
@@ -515,6 +940,8 @@ void UsageMessage(const char *command) {
       "  -load: run the loading phase of the workload\n"
       "  -t: run the transactions phase of the workload\n"
       "  -run: same as -t\n"
+      "  -mrc: predict the LRU cache hit ratio of the transactions phase by cache size,\n"
+      "        from the generated keys only (mrc.rate, mrc.file)\n"
       "  -threads n: execute using n threads (default: 1)\n"
       "  -db dbname: specify the name of the DB to use (default: basic)\n"
       "  -P propertyfile: load properties from the given file. Multiple files can\n"
@@ -522,10 +949,44 @@ void UsageMessage(const char *command) {
       "  -p name=value: specify a property to be passed to the DB and workloads\n"
       "                 multiple properties can be specified, and override any\n"
       "                 values in the propertyfile\n"
-      "  -s: print status every 10 seconds (use status.interval prop to override)"
+      "  -s: print status every 10 seconds (use status.interval prop to override)\n"
+      "  -export file: write the results as JSON, or as CSV if file ends with .csv"
       << std::endl;
 }
 
+// Feeds the keys of operationcount transactions of the workload, without any
+// DB, into a miss ratio curve and prints it.
+void PrintMissRatioCurve(ycsbc::utils::Properties &props) {
+  ycsbc::CoreWorkload *wl = ycsbc::CreateWorkload(props);
+  if (wl == nullptr) {
+    std::cerr << "Unknown workload " << props.GetProperty(ycsbc::CoreWorkload::WORKLOAD_PROPERTY)
+              << std::endl;
+    exit(1);
+  }
+  try {
+    wl->Init(props);
+    ycsbc::MissRatioCurve mrc(&props);
+    const uint64_t total_ops = std::stoull(props[ycsbc::CoreWorkload::OPERATION_COUNT_PROPERTY]);
+    const int num_threads = stoi(props.GetProperty("threadcount", "1"));
+    for (uint64_t i = 0; i < total_ops; i++) {
+      // interleave the client threads, which draw from their own key
+      // ranges with keypartitioning=thread
+      wl->InitThread(i % num_threads);
+      uint64_t key_num;
+      if (!wl->NextAccessKeyNum(&key_num)) {
+        std::cerr << "The workload does not support -mrc" << std::endl;
+        exit(1);
+      }
+      mrc.Add(key_num);
+    }
+    mrc.Print();
+  } catch (const ycsbc::utils::Exception &e) {
+    std::cerr << "Caught exception:" << e.what() << std::endl;
+    exit(1);
+  }
+  delete wl;
+}
+
 inline bool StrStartWith(const char *str, const char *pre) {
   return strncmp(str, pre, strlen(pre)) == 0;
 }
@@ -0,0 +1,23 @@
+#/bin/bash
+
+# read-modify-write contention as the hot set shrinks
+# usage: test_sh/hotkey_rmw_sweep.sh [db] [dbpath] [threads]
+
+db=${1:-rocksdb}
+dbpath=${2:-"/home/share/ceshi"}
+threads=${3:-16}
+workload="workloads/hotkey_rmw_workload"
+
+if [ -n "$dbpath" ];then
+    rm -rf $dbpath/*
+fi
+
+cmd="./ycsbc -db $db -dbpath $dbpath -threads $threads -P $workload -load"
+echo $cmd
+eval $cmd
+
+for hot in 10000 1000 100 16 4 1; do
+    cmd="./ycsbc -db $db -dbpath $dbpath -threads $threads -P $workload -run -p hotkeycount=$hot"
+    echo $cmd
+    eval $cmd
+done
@@ -0,0 +1,769 @@
+//
+//  ycsb_compare.cc
+//  YCSB-cpp
+//
+//  Compares groups of repeated runs, either results written with -export or
+//  interval logs written by measurement.histogram.log, against a baseline.
+//
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <hdr/hdr_histogram.h>
+#include <hdr/hdr_histogram_log.h>
+
+#include "utils/utils.h"
+
+using ycsbc::utils::Exception;
+
+namespace {
+
+struct Options {
+  double threshold = 5.0;
+  double confidence = 95.0;
+  int bootstrap = 1000;
+  uint64_t seed = 0;
+  std::string phase = "run";
+  std::vector<double> percentiles = {50, 90, 99, 99.9};
+  std::vector<std::vector<std::string>> groups;
+};
+
+// op (or TOTAL) -> metric -> value, as found in one exported result file
+struct RunSummary {
+  std::string latency_unit;
+  std::map<std::string, std::map<std::string, double>> ops;
+};
+
+// one interval of an interval log, as recorded (value, count) pairs
+struct Interval {
+  double length;
+  int64_t total;
+  int64_t max;
+  std::vector<std::pair<int64_t, int64_t>> counts;
+};
+
+struct Group {
+  std::string label;
+  bool from_logs = false;
+  std::vector<RunSummary> runs;
+  // op -> intervals of each run of the group
+  std::map<std::string, std::vector<std::vector<Interval>>> intervals;
+};
+
+const char kTotal[] = "TOTAL";
+
+std::string PercentileKey(double p) {
+  std::ostringstream out;
+  out << p;
+  return out.str();
+}
+
+bool EndsWith(const std::string &str, const std::string &suffix) {
+  return str.size() >= suffix.size() && str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+std::vector<std::string> Split(const std::string &str, char sep) {
+  std::vector<std::string> parts;
+  std::string::size_type begin = 0;
+  while (true) {
+    std::string::size_type end = str.find(sep, begin);
+    parts.push_back(str.substr(begin, end == std::string::npos ? std::string::npos : end - begin));
+    if (end == std::string::npos) {
+      return parts;
+    }
+    begin = end + 1;
+  }
+}
+
+//
+// minimal JSON reader, enough for the documents written by ResultsExporter
+//
+struct Json {
+  enum Type { kNull, kBool, kNumber, kString, kArray, kObject } type = kNull;
+  double number = 0;
+  std::string str;
+  std::vector<Json> items;
+  std::vector<std::pair<std::string, Json>> members;
+
+  const Json *Get(const std::string &key) const {
+    for (auto &m : members) {
+      if (m.first == key) {
+        return &m.second;
+      }
+    }
+    return nullptr;
+  }
+};
+
+class JsonParser {
+ public:
+  JsonParser(const std::string &text) : text_(text), pos_(0) {}
+
+  Json Parse() {
+    Json value = ParseValue();
+    SkipSpace();
+    if (pos_ != text_.size()) {
+      Fail("trailing data");
+    }
+    return value;
+  }
+
+ private:
+  void Fail(const std::string &what) {
+    throw Exception("invalid JSON at offset " + std::to_string(pos_) + ": " + what);
+  }
+
+  void SkipSpace() {
+    while (pos_ < text_.size() && std::isspace(static_cast<unsigned char>(text_[pos_]))) {
+      pos_++;
+    }
+  }
+
+  void Expect(char c) {
+    SkipSpace();
+    if (pos_ >= text_.size() || text_[pos_] != c) {
+      Fail(std::string("expected '") + c + "'");
+    }
+    pos_++;
+  }
+
+  bool Consume(const char *literal) {
+    size_t len = strlen(literal);
+    if (text_.compare(pos_, len, literal) == 0) {
+      pos_ += len;
+      return true;
+    }
+    return false;
+  }
+
+  std::string ParseString() {
+    Expect('"');
+    std::string out;
+    while (pos_ < text_.size() && text_[pos_] != '"') {
+      char c = text_[pos_++];
+      if (c != '\\') {
+        out += c;
+        continue;
+      }
+      if (pos_ >= text_.size()) {
+        break;
+      }
+      c = text_[pos_++];
+      switch (c) {
+        case 'n': out += '\n'; break;
+        case 'r': out += '\r'; break;
+        case 't': out += '\t'; break;
+        case 'b': out += '\b'; break;
+        case 'f': out += '\f'; break;
+        case 'u':
+          // only the control characters the exporter escapes are expected
+          if (pos_ + 4 > text_.size()) {
+            Fail("bad escape");
+          }
+          out += static_cast<char>(std::stoi(text_.substr(pos_, 4), nullptr, 16));
+          pos_ += 4;
+          break;
+        default: out += c;
+      }
+    }
+    Expect('"');
+    return out;
+  }
+
+  Json ParseValue() {
+    SkipSpace();
+    if (pos_ >= text_.size()) {
+      Fail("unexpected end");
+    }
+    Json value;
+    char c = text_[pos_];
+    if (c == '{') {
+      value.type = Json::kObject;
+      pos_++;
+      SkipSpace();
+      if (pos_ < text_.size() && text_[pos_] == '}') {
+        pos_++;
+        return value;
+      }
+      do {
+        std::string key = ParseString();
+        Expect(':');
+        value.members.emplace_back(key, ParseValue());
+        SkipSpace();
+      } while (pos_ < text_.size() && text_[pos_] == ',' && ++pos_);
+      Expect('}');
+    } else if (c == '[') {
+      value.type = Json::kArray;
+      pos_++;
+      SkipSpace();
+      if (pos_ < text_.size() && text_[pos_] == ']') {
+        pos_++;
+        return value;
+      }
+      do {
+        value.items.push_back(ParseValue());
+        SkipSpace();
+      } while (pos_ < text_.size() && text_[pos_] == ',' && ++pos_);
+      Expect(']');
+    } else if (c == '"') {
+      value.type = Json::kString;
+      value.str = ParseString();
+    } else if (Consume("null")) {
+      value.type = Json::kNull;
+    } else if (Consume("true")) {
+      value.type = Json::kBool;
+      value.number = 1;
+    } else if (Consume("false")) {
+      value.type = Json::kBool;
+    } else {
+      const char *begin = text_.c_str() + pos_;
+      char *end;
+      value.number = strtod(begin, &end);
+      if (end == begin) {
+        Fail("unexpected character");
+      }
+      value.type = Json::kNumber;
+      pos_ += end - begin;
+    }
+    return value;
+  }
+
+  const std::string &text_;
+  size_t pos_;
+};
+
+std::string ReadFile(const std::string &path) {
+  std::ifstream input(path);
+  if (!input.is_open()) {
+    throw Exception("failed to open: " + path);
+  }
+  std::stringstream buffer;
+  buffer << input.rdbuf();
+  return buffer.str();
+}
+
+RunSummary LoadJson(const std::string &path, const std::string &phase) {
+  std::string text = ReadFile(path);
+  Json doc = JsonParser(text).Parse();
+  RunSummary run;
+  const Json *info = doc.Get("info");
+  const Json *unit = info ? info->Get("latency_unit") : nullptr;
+  if (unit) {
+    run.latency_unit = unit->str;
+  }
+  const Json *phases = doc.Get("phases");
+  if (!phases) {
+    throw Exception(path + ": no phases");
+  }
+  for (const Json &p : phases->items) {
+    const Json *name = p.Get("phase");
+    if (!name || name->str != phase) {
+      continue;
+    }
+    const Json *throughput = p.Get("throughput");
+    if (throughput && throughput->type == Json::kNumber) {
+      run.ops[kTotal]["throughput"] = throughput->number;
+    }
+    const Json *ops = p.Get("ops");
+    if (!ops) {
+      continue;
+    }
+    for (auto &op : ops->members) {
+      std::map<std::string, double> &metrics = run.ops[op.first];
+      for (const char *key : {"throughput", "mean"}) {
+        const Json *v = op.second.Get(key);
+        if (v && v->type == Json::kNumber) {
+          metrics[key] = v->number;
+        }
+      }
+      const Json *percentiles = op.second.Get("percentiles");
+      if (percentiles) {
+        for (auto &pct : percentiles->members) {
+          if (pct.second.type == Json::kNumber) {
+            metrics["p" + pct.first] = pct.second.number;
+          }
+        }
+      }
+    }
+  }
+  if (run.ops.empty()) {
+    throw Exception(path + ": no results for phase " + phase);
+  }
+  return run;
+}
+
+std::vector<std::string> SplitCsvLine(const std::string &line) {
+  std::vector<std::string> fields(1);
+  bool quoted = false;
+  for (size_t i = 0; i < line.size(); i++) {
+    char c = line[i];
+    if (quoted) {
+      if (c == '"' && i + 1 < line.size() && line[i + 1] == '"') {
+        fields.back() += '"';
+        i++;
+      } else if (c == '"') {
+        quoted = false;
+      } else {
+        fields.back() += c;
+      }
+    } else if (c == '"') {
+      quoted = true;
+    } else if (c == ',') {
+      fields.emplace_back();
+    } else if (c != '\r') {
+      fields.back() += c;
+    }
+  }
+  return fields;
+}
+
+RunSummary LoadCsv(const std::string &path, const std::string &phase) {
+  std::ifstream input(path);
+  if (!input.is_open()) {
+    throw Exception("failed to open: " + path);
+  }
+  RunSummary run;
+  std::string line;
+  std::getline(input, line); // header
+  while (std::getline(input, line)) {
+    std::vector<std::string> fields = SplitCsvLine(line);
+    if (fields.size() != 4) {
+      continue;
+    }
+    const std::string &item = fields[1];
+    const std::string &metric = fields[2];
+    if (item == "info" && metric == "latency_unit") {
+      run.latency_unit = fields[3];
+    }
+    if (fields[0] != phase || item == "metric" || item.compare(0, 7, "series@") == 0 ||
+        fields[3] == "null") {
+      continue;
+    }
+    if (item == "phase") {
+      if (metric == "throughput") {
+        run.ops[kTotal]["throughput"] = std::stod(fields[3]);
+      }
+    } else if (metric == "throughput" || metric == "mean" || metric[0] == 'p') {
+      run.ops[item][metric] = std::stod(fields[3]);
+    }
+  }
+  if (run.ops.empty()) {
+    throw Exception(path + ": no results for phase " + phase);
+  }
+  return run;
+}
+
+// reads the tagged lines of an interval log; untagged lines are accounted as ALL. Tags
+// are phase.OPERATION, lines of other phases are skipped; tags without a phase match any
+void LoadIntervalLog(const std::string &path, const std::string &phase,
+                     std::map<std::string, std::vector<Interval>> *intervals) {
+  std::ifstream input(path);
+  if (!input.is_open()) {
+    throw Exception("failed to open: " + path);
+  }
+  std::string line;
+  size_t read = 0;
+  while (std::getline(input, line)) {
+    if (line.empty() || line[0] == '#' || line[0] == '"') {
+      continue;
+    }
+    std::string tag = "ALL";
+    if (line.compare(0, 4, "Tag=") == 0) {
+      std::string::size_type comma = line.find(',');
+      if (comma == std::string::npos) {
+        continue;
+      }
+      tag = line.substr(4, comma - 4);
+      line = line.substr(comma + 1);
+      std::string::size_type dot = tag.find('.');
+      if (dot != std::string::npos) {
+        if (tag.compare(0, dot, phase) != 0) {
+          continue;
+        }
+        tag = tag.substr(dot + 1);
+      }
+    }
+    std::vector<std::string> fields = Split(line, ',');
+    if (fields.size() != 4) {
+      throw Exception(path + ": malformed interval line");
+    }
+    hdr_histogram *histogram = nullptr;
+    std::string encoded = fields[3];
+    if (hdr_log_decode(&histogram, &encoded[0], encoded.size()) != 0 || histogram == nullptr) {
+      throw Exception(path + ": failed to decode interval histogram");
+    }
+    Interval interval;
+    interval.length = std::stod(fields[1]);
+    interval.total = histogram->total_count;
+    interval.max = hdr_max(histogram);
+    hdr_iter iter;
+    hdr_iter_recorded_init(&iter, histogram);
+    while (hdr_iter_next(&iter)) {
+      interval.counts.emplace_back(iter.value, iter.count);
+    }
+    hdr_close(histogram);
+    (*intervals)[tag].push_back(std::move(interval));
+    read++;
+  }
+  if (read == 0) {
+    throw Exception(path + ": no intervals for phase " + phase);
+  }
+}
+
+Group LoadGroup(const std::vector<std::string> &files, const Options &opts) {
+  Group group;
+  group.label = files[0] + (files.size() > 1 ? " (+" + std::to_string(files.size() - 1) + ")" : "");
+  for (size_t i = 0; i < files.size(); i++) {
+    const std::string &file = files[i];
+    bool is_log = !EndsWith(file, ".json") && !EndsWith(file, ".csv");
+    if (i > 0 && is_log != group.from_logs) {
+      throw Exception("cannot mix exported results and interval logs: " + file);
+    }
+    group.from_logs = is_log;
+    if (is_log) {
+      std::map<std::string, std::vector<Interval>> intervals;
+      LoadIntervalLog(file, opts.phase, &intervals);
+      for (auto &op : intervals) {
+        group.intervals[op.first].push_back(std::move(op.second));
+      }
+    } else {
+      group.runs.push_back(EndsWith(file, ".csv") ? LoadCsv(file, opts.phase) : LoadJson(file, opts.phase));
+      if (group.runs.back().latency_unit != group.runs.front().latency_unit) {
+        throw Exception("latency units differ: " + file);
+      }
+    }
+  }
+  return group;
+}
+
+//
+// Estimators over resampling units, which are whole runs: the intervals of
+// one run are correlated, so only runs are resampled. Both compute every
+// metric of one op from the runs selected by idx (with repetition).
+//
+class Estimator {
+ public:
+  virtual ~Estimator() {}
+  virtual size_t Units() const = 0;
+  virtual std::map<std::string, double> Estimate(const std::vector<size_t> &idx) = 0;
+};
+
+class SummaryEstimator : public Estimator {
+ public:
+  SummaryEstimator(const Group &group, const std::string &op) {
+    for (const RunSummary &run : group.runs) {
+      auto it = run.ops.find(op);
+      if (it != run.ops.end()) {
+        runs_.push_back(&it->second);
+      }
+    }
+  }
+
+  size_t Units() const override { return runs_.size(); }
+
+  std::map<std::string, double> Estimate(const std::vector<size_t> &idx) override {
+    std::map<std::string, double> sum;
+    std::map<std::string, size_t> cnt;
+    for (size_t i : idx) {
+      for (auto &metric : *runs_[i]) {
+        sum[metric.first] += metric.second;
+        cnt[metric.first]++;
+      }
+    }
+    for (auto &metric : sum) {
+      metric.second /= cnt[metric.first];
+    }
+    return sum;
+  }
+
+ private:
+  std::vector<const std::map<std::string, double> *> runs_;
+};
+
+class IntervalEstimator : public Estimator {
+ public:
+  IntervalEstimator(const std::vector<std::vector<Interval>> &runs, const std::vector<double> &percentiles)
+      : runs_(runs), percentiles_(percentiles), merged_(nullptr) {
+    int64_t highest = 2;
+    for (const std::vector<Interval> &run : runs_) {
+      for (const Interval &interval : run) {
+        highest = std::max(highest, interval.max);
+      }
+    }
+    if (hdr_init(1, highest, 3, &merged_) != 0) {
+      throw Exception("failed to init hdrhistogram");
+    }
+  }
+
+  ~IntervalEstimator() override { hdr_close(merged_); }
+
+  size_t Units() const override { return runs_.size(); }
+
+  std::map<std::string, double> Estimate(const std::vector<size_t> &idx) override {
+    hdr_reset(merged_);
+    double length = 0;
+    int64_t total = 0;
+    for (size_t i : idx) {
+      for (const Interval &interval : runs_[i]) {
+        length += interval.length;
+        total += interval.total;
+        for (auto &count : interval.counts) {
+          hdr_record_values(merged_, count.first, count.second);
+        }
+      }
+    }
+    std::map<std::string, double> metrics;
+    if (length > 0) {
+      metrics["throughput"] = total / length;
+    }
+    if (total > 0) {
+      metrics["mean"] = hdr_mean(merged_);
+      for (double p : percentiles_) {
+        metrics["p" + PercentileKey(p)] = hdr_value_at_percentile(merged_, p);
+      }
+    }
+    return metrics;
+  }
+
+ private:
+  const std::vector<std::vector<Interval>> &runs_;
+  const std::vector<double> &percentiles_;
+  hdr_histogram *merged_;
+};
+
+std::unique_ptr<Estimator> MakeEstimator(const Group &group, const std::string &op, const Options &opts) {
+  if (group.from_logs) {
+    auto it = group.intervals.find(op);
+    if (it == group.intervals.end()) {
+      return nullptr;
+    }
+    return std::unique_ptr<Estimator>(new IntervalEstimator(it->second, opts.percentiles));
+  }
+  std::unique_ptr<Estimator> estimator(new SummaryEstimator(group, op));
+  return estimator->Units() > 0 ? std::move(estimator) : nullptr;
+}
+
+std::vector<std::string> OpNames(const Group &group) {
+  std::vector<std::string> names;
+  if (group.from_logs) {
+    for (auto &op : group.intervals) {
+      names.push_back(op.first);
+    }
+  } else {
+    for (const RunSummary &run : group.runs) {
+      for (auto &op : run.ops) {
+        if (std::find(names.begin(), names.end(), op.first) == names.end()) {
+          names.push_back(op.first);
+        }
+      }
+    }
+  }
+  return names;
+}
+
+std::vector<std::string> MetricNames(const Options &opts) {
+  std::vector<std::string> names = {"throughput", "mean"};
+  for (double p : opts.percentiles) {
+    names.push_back("p" + PercentileKey(p));
+  }
+  return names;
+}
+
+std::vector<size_t> AllUnits(size_t n) {
+  std::vector<size_t> idx(n);
+  for (size_t i = 0; i < n; i++) {
+    idx[i] = i;
+  }
+  return idx;
+}
+
+std::vector<size_t> Resample(size_t n, std::mt19937_64 &rng) {
+  std::uniform_int_distribution<size_t> pick(0, n - 1);
+  std::vector<size_t> idx(n);
+  for (size_t i = 0; i < n; i++) {
+    idx[i] = pick(rng);
+  }
+  return idx;
+}
+
+double Quantile(std::vector<double> &values, double q) {
+  size_t i = std::min(values.size() - 1, static_cast<size_t>(q * (values.size() - 1) + 0.5));
+  std::nth_element(values.begin(), values.begin() + i, values.end());
+  return values[i];
+}
+
+// returns the number of regressions
+int Compare(const Group &base, const Group &test, const Options &opts, std::mt19937_64 &rng) {
+  int regressions = 0;
+  std::vector<std::string> metric_names = MetricNames(opts);
+  printf("%-24s %-10s %14s %14s %9s  %-20s\n", "operation", "metric", "baseline", "candidate",
+         "delta", "ci");
+  for (const std::string &op : OpNames(base)) {
+    std::unique_ptr<Estimator> b = MakeEstimator(base, op, opts);
+    std::unique_ptr<Estimator> t = MakeEstimator(test, op, opts);
+    if (!b || !t) {
+      continue;
+    }
+    std::map<std::string, double> b_point = b->Estimate(AllUnits(b->Units()));
+    std::map<std::string, double> t_point = t->Estimate(AllUnits(t->Units()));
+
+    // bootstrap the relative difference; needs repeated runs on both sides
+    std::map<std::string, std::vector<double>> deltas;
+    if (opts.bootstrap > 0 && b->Units() > 1 && t->Units() > 1) {
+      for (int r = 0; r < opts.bootstrap; r++) {
+        std::map<std::string, double> b_rep = b->Estimate(Resample(b->Units(), rng));
+        std::map<std::string, double> t_rep = t->Estimate(Resample(t->Units(), rng));
+        for (auto &metric : b_rep) {
+          auto it = t_rep.find(metric.first);
+          if (it != t_rep.end() && metric.second != 0) {
+            deltas[metric.first].push_back((it->second / metric.second - 1) * 100);
+          }
+        }
+      }
+    }
+
+    for (const std::string &metric : metric_names) {
+      auto bi = b_point.find(metric);
+      auto ti = t_point.find(metric);
+      if (bi == b_point.end() || ti == t_point.end() || bi->second == 0) {
+        continue;
+      }
+      double delta = (ti->second / bi->second - 1) * 100;
+      // throughput regresses when it drops, latencies when they grow
+      double worse = (metric == "throughput") ? -delta : delta;
+
+      // without a bootstrap interval only -bootstrap 0 flags on the threshold alone
+      char ci[64] = "-";
+      bool significant = opts.bootstrap == 0;
+      auto di = deltas.find(metric);
+      if (di != deltas.end() && !di->second.empty()) {
+        double alpha = (1 - opts.confidence / 100) / 2;
+        double lo = Quantile(di->second, alpha);
+        double hi = Quantile(di->second, 1 - alpha);
+        snprintf(ci, sizeof(ci), "[%+.2f%%, %+.2f%%]", lo, hi);
+        significant = lo > 0 || hi < 0;
+      }
+
+      const char *verdict = "";
+      if (significant && worse > opts.threshold) {
+        verdict = "REGRESSION";
+        regressions++;
+      } else if (significant && -worse > opts.threshold) {
+        verdict = "improved";
+      }
+      printf("%-24s %-10s %14.2f %14.2f %+8.2f%%  %-20s %s\n", op.c_str(), metric.c_str(),
+             bi->second, ti->second, delta, ci, verdict);
+    }
+  }
+  return regressions;
+}
+
+void UsageMessage(const char *command) {
+  std::cout <<
+      "Usage: " << command << " [options] baseline candidate [candidate ...]\n"
+      "Each argument is a comma separated list of repeated runs: result files\n"
+      "written with -export (.json or .csv), or interval logs written with\n"
+      "-p measurement.histogram.log=file. Every candidate is compared with the\n"
+      "baseline. Whole runs are resampled as units, the intervals of a run's\n"
+      "interval log are merged; a change is flagged when its bootstrap interval\n"
+      "excludes zero, which needs at least two runs per side.\n"
+      "Options:\n"
+      "  -threshold pct: flag changes larger than pct percent (default: 5)\n"
+      "  -confidence pct: confidence level of the bootstrap interval (default: 95)\n"
+      "  -bootstrap n: number of bootstrap resamples, 0 flags on the threshold alone (default: 1000)\n"
+      "  -seed n: seed of the bootstrap (default: 0)\n"
+      "  -phase name: phase of exported results and interval logs to compare (default: run)\n"
+      "  -percentiles list: comma separated latency percentiles (default: 50,90,99,99.9)\n"
+      "Exits with 1 if a regression is flagged."
+      << std::endl;
+}
+
+void ParseCommandLine(int argc, const char *argv[], Options *opts) {
+  int argindex = 1;
+  while (argindex < argc && argv[argindex][0] == '-') {
+    std::string opt = argv[argindex++];
+    if (argindex >= argc) {
+      UsageMessage(argv[0]);
+      std::cerr << "Missing argument value for " << opt << std::endl;
+      exit(2);
+    }
+    std::string value = argv[argindex++];
+    if (opt == "-threshold") {
+      opts->threshold = std::stod(value);
+    } else if (opt == "-confidence") {
+      opts->confidence = std::stod(value);
+    } else if (opt == "-bootstrap") {
+      opts->bootstrap = std::stoi(value);
+    } else if (opt == "-seed") {
+      opts->seed = std::stoull(value);
+    } else if (opt == "-phase") {
+      opts->phase = value;
+    } else if (opt == "-percentiles") {
+      opts->percentiles.clear();
+      for (const std::string &p : Split(value, ',')) {
+        opts->percentiles.push_back(std::stod(p));
+      }
+    } else {
+      UsageMessage(argv[0]);
+      std::cerr << "Unknown option '" << opt << "'" << std::endl;
+      exit(2);
+    }
+  }
+  for (; argindex < argc; argindex++) {
+    opts->groups.push_back(Split(argv[argindex], ','));
+  }
+  if (opts->groups.size() < 2) {
+    UsageMessage(argv[0]);
+    exit(2);
+  }
+}
+
+} // anonymous
+
+int main(const int argc, const char *argv[]) {
+  Options opts;
+  ParseCommandLine(argc, argv, &opts);
+
+  int regressions = 0;
+  try {
+    std::vector<Group> groups;
+    for (auto &files : opts.groups) {
+      groups.push_back(LoadGroup(files, opts));
+      if (groups.back().from_logs != groups.front().from_logs) {
+        throw Exception("cannot compare exported results with interval logs");
+      }
+      if (!groups.back().from_logs &&
+          groups.back().runs.front().latency_unit != groups.front().runs.front().latency_unit) {
+        throw Exception("latency units differ between baseline and candidate");
+      }
+    }
+
+    std::mt19937_64 rng(opts.seed);
+    for (size_t i = 1; i < groups.size(); i++) {
+      printf("********** %s vs %s **********\n", groups[0].label.c_str(), groups[i].label.c_str());
+      regressions += Compare(groups[0], groups[i], opts, rng);
+    }
+  } catch (const Exception &e) {
+    std::cerr << "Caught exception: " << e.what() << std::endl;
+    return 2;
+  }
+
+  if (regressions > 0) {
+    printf("%d regression(s) above %.2f%%\n", regressions, opts.threshold);
+    return 1;
+  }
+  return 0;
+}
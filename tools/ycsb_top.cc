@@ -0,0 +1,171 @@
+//
+//  ycsb_top.cc
+//  YCSB-cpp
+//
+//  Attaches to the shared memory segment of a running ycsb (-p shm.name=...)
+//  and renders its live throughput, latency percentiles and engine metrics.
+//
+
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "core/shm_metrics.h"
+#include "utils/utils.h"
+
+using ycsbc::utils::Exception;
+namespace shm = ycsbc::shm;
+
+namespace {
+
+struct Options {
+  int refresh_ms = 1000;
+  bool once = false;
+  std::string filter; // engine metrics containing it, all if empty
+  std::string name;
+};
+
+const shm::Segment *Attach(const std::string &name) {
+  int fd = shm_open(name.c_str(), O_RDONLY, 0);
+  if (fd < 0) {
+    throw Exception("shm_open failed: " + name + ": " + strerror(errno));
+  }
+  void *addr = mmap(nullptr, sizeof(shm::Segment), PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED) {
+    throw Exception("mmap failed: " + name + ": " + strerror(errno));
+  }
+  const shm::Segment *segment = static_cast<const shm::Segment *>(addr);
+  if (segment->magic != shm::kMagic) {
+    throw Exception(name + ": not a ycsb metrics segment");
+  }
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (segment->version != shm::kVersion) {
+    throw Exception(name + ": segment version " + std::to_string(segment->version) +
+                    ", expected " + std::to_string(shm::kVersion));
+  }
+  return segment;
+}
+
+const char *StateString(uint32_t state) {
+  switch (state) {
+    case shm::kIdle: return "starting";
+    case shm::kRunning: return "running";
+    case shm::kFinished: return "finished";
+    default: return "unknown";
+  }
+}
+
+void Render(const shm::Snapshot &s, const Options &opts, bool writer_alive) {
+  if (!opts.once) {
+    // home and clear screen
+    printf("\033[H\033[2J");
+  }
+  uint64_t interval_ops = 0;
+  for (uint32_t i = 0; i < s.num_ops; i++) {
+    interval_ops += s.ops[i].interval_count;
+  }
+  printf("ycsb pid %d  db %s  phase %s  %s%s\n", s.pid, s.dbname, s.phase[0] ? s.phase : "-",
+         StateString(s.state), writer_alive ? "" : " (exited)");
+  printf("elapsed %.1f s  operations %lu  throughput %.2f ops/sec (last %.2f s)\n\n",
+         s.elapsed_sec, s.operations, s.interval_sec > 0 ? interval_ops / s.interval_sec : 0,
+         s.interval_sec);
+  printf("%-24s %12s %12s %10s %10s %10s %10s %10s %10s\n", "op", "total", "ops/sec",
+         "avg(us)", "p50(us)", "p90(us)", "p99(us)", "p99.9(us)", "max(us)");
+  for (uint32_t i = 0; i < s.num_ops; i++) {
+    const shm::OpStats &op = s.ops[i];
+    printf("%-24s %12lu %12.2f %10.2f %10.2f %10.2f %10.2f %10.2f %10.2f\n", op.name, op.total_count,
+           s.interval_sec > 0 ? op.interval_count / s.interval_sec : 0, op.mean_ns / 1000,
+           op.p50_ns / 1000.0, op.p90_ns / 1000.0, op.p99_ns / 1000.0, op.p999_ns / 1000.0,
+           op.max_ns / 1000.0);
+  }
+  if (s.num_engine_metrics > 0) {
+    printf("\nengine metrics\n");
+    for (uint32_t i = 0; i < s.num_engine_metrics; i++) {
+      const shm::EngineMetric &m = s.engine_metrics[i];
+      if (!opts.filter.empty() && strstr(m.name, opts.filter.c_str()) == nullptr) {
+        continue;
+      }
+      printf("  %-56s %20.15g\n", m.name, m.value);
+    }
+  }
+  fflush(stdout);
+}
+
+void UsageMessage(const char *command) {
+  std::cout <<
+      "Usage: " << command << " [options] name\n"
+      "Renders the live metrics a ycsb run publishes with -p shm.name=name.\n"
+      "Options:\n"
+      "  -refresh ms: refresh interval (default: 1000)\n"
+      "  -filter str: only show engine metrics whose name contains str\n"
+      "  -once: print one snapshot and exit"
+      << std::endl;
+}
+
+void ParseCommandLine(int argc, const char *argv[], Options *opts) {
+  int argindex = 1;
+  while (argindex < argc && argv[argindex][0] == '-') {
+    std::string opt = argv[argindex++];
+    if (opt == "-once") {
+      opts->once = true;
+      continue;
+    }
+    if (argindex >= argc) {
+      UsageMessage(argv[0]);
+      std::cerr << "Missing argument value for " << opt << std::endl;
+      exit(2);
+    }
+    std::string value = argv[argindex++];
+    if (opt == "-refresh") {
+      opts->refresh_ms = std::stoi(value);
+    } else if (opt == "-filter") {
+      opts->filter = value;
+    } else {
+      UsageMessage(argv[0]);
+      std::cerr << "Unknown option '" << opt << "'" << std::endl;
+      exit(2);
+    }
+  }
+  if (argindex != argc - 1) {
+    UsageMessage(argv[0]);
+    exit(2);
+  }
+  opts->name = argv[argindex];
+}
+
+} // anonymous
+
+int main(const int argc, const char *argv[]) {
+  Options opts;
+  ParseCommandLine(argc, argv, &opts);
+
+  try {
+    const shm::Segment *segment = Attach(opts.name);
+    shm::Snapshot snapshot;
+    while (true) {
+      shm::Read(segment, &snapshot);
+      // the segment outlives a crashed writer, its pid tells
+      bool writer_alive = kill(snapshot.pid, 0) == 0 || errno == EPERM;
+      Render(snapshot, opts, writer_alive);
+      if (opts.once || !writer_alive) {
+        break;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(opts.refresh_ms));
+    }
+  } catch (const Exception &e) {
+    std::cerr << "Caught exception: " << e.what() << std::endl;
+    return 2;
+  }
+  return 0;
+}
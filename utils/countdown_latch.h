@@ -8,6 +8,7 @@
 #ifndef YCSB_C_COUNTDOWN_LATCH_H_
 #define YCSB_C_COUNTDOWN_LATCH_H_
 
+#include <chrono>
 #include <mutex>
 #include <condition_variable>
 
@@ -23,8 +24,12 @@ class CountDownLatch {
     cv_.wait(lock, [this]{return count_ <= 0;});
   }
   bool AwaitFor(long timeout_sec) {
+    return AwaitFor(std::chrono::seconds(timeout_sec));
+  }
+  template <typename R, typename P>
+  bool AwaitFor(const std::chrono::duration<R, P> &timeout) {
     std::unique_lock<std::mutex> lock(mu_);
-    return cv_.wait_for(lock, std::chrono::seconds(timeout_sec), [this]{return count_ <= 0;});
+    return cv_.wait_for(lock, timeout, [this]{return count_ <= 0;});
   }
   void CountDown() {
     std::unique_lock<std::mutex> lock(mu_);
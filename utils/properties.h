@@ -29,6 +29,7 @@ class Properties {
   bool ContainsKey(const std::string &key) const;
   void Load(std::ifstream &input);
   std::string DebugString();
+  const std::map<std::string, std::string> &GetProperties() const { return properties_; }
  private:
   std::map<std::string, std::string> properties_;
 };
@@ -10,6 +10,15 @@
 #define YCSB_C_TIMER_H_
 
 #include <chrono>
+#include <cstdint>
+#include <ctime>
+
+// the TSC path needs __int128 for the scaling, which GCC and Clang provide
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__) && defined(__SIZEOF_INT128__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#define YCSB_C_HAVE_TSC
+#endif
 
 namespace ycsbc {
 
@@ -36,6 +45,102 @@ class Timer {
   Clock::time_point time_;
 };
 
+///
+/// Nanosecond clock of the measurement path. Reads CLOCK_MONOTONIC (the
+/// steady clock where that is unavailable), or the TSC scaled by a
+/// calibrated multiplier if Init(true) finds an invariant TSC.
+///
+class NanoClock {
+ public:
+  ///
+  /// Selects the time source. Must be called before any thread calls Now().
+  ///
+  static void Init(bool use_tsc) {
+    tsc_ = false;
+#ifdef YCSB_C_HAVE_TSC
+    if (use_tsc && InvariantTsc()) {
+      Calibrate();
+      tsc_ = true;
+    }
+#endif
+  }
+
+  static uint64_t Now() {
+#ifdef YCSB_C_HAVE_TSC
+    if (tsc_) {
+      uint64_t ticks = __rdtsc() - base_ticks_;
+      return base_ns_ + static_cast<uint64_t>((static_cast<unsigned __int128>(ticks) * mult_) >> kShift);
+    }
+#endif
+    return MonotonicNs();
+  }
+
+  static bool UsingTsc() { return tsc_; }
+
+  /// TSC ticks per nanosecond, 0 if the TSC is not used.
+  static double TscGhz() { return tsc_ ? static_cast<double>(1ull << kShift) / mult_ : 0; }
+
+ private:
+  static uint64_t MonotonicNs() {
+#ifdef CLOCK_MONOTONIC
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+  }
+
+#ifdef YCSB_C_HAVE_TSC
+  static bool InvariantTsc() {
+    unsigned int eax, ebx, ecx, edx;
+    if (__get_cpuid_max(0x80000000, nullptr) < 0x80000007) {
+      return false;
+    }
+    __cpuid(0x80000007, eax, ebx, ecx, edx);
+    return (edx & (1u << 8)) != 0;
+  }
+
+  // ns = ticks * mult_ >> kShift, measured against CLOCK_MONOTONIC over ~50 ms
+  static void Calibrate() {
+    uint64_t ns0 = MonotonicNs();
+    uint64_t ticks0 = __rdtsc();
+    uint64_t ns1;
+    do {
+      ns1 = MonotonicNs();
+    } while (ns1 - ns0 < 50 * 1000 * 1000);
+    uint64_t ticks1 = __rdtsc();
+    mult_ = static_cast<uint64_t>((static_cast<unsigned __int128>(ns1 - ns0) << kShift) / (ticks1 - ticks0));
+    base_ticks_ = ticks1;
+    base_ns_ = ns1;
+  }
+#endif
+
+  static constexpr int kShift = 32;
+  static inline bool tsc_ = false;
+  static inline uint64_t mult_ = 0;
+  static inline uint64_t base_ticks_ = 0;
+  static inline uint64_t base_ns_ = 0;
+};
+
+///
+/// Latency timer on NanoClock, in nanoseconds.
+///
+class NanoTimer {
+ public:
+  void Start() {
+    time_ = NanoClock::Now();
+  }
+
+  uint64_t End() {
+    return NanoClock::Now() - time_;
+  }
+
+ private:
+  uint64_t time_;
+};
+
 } // utils
 
 } // ycsbc
@@ -13,8 +13,10 @@
 #include <algorithm>
 #include <cstdint>
 #include <exception>
+#include <filesystem>
 #include <random>
 #include <locale>
+#include <string>
 
 #if defined(_MSC_VER)
 #if _MSC_VER >= 1911
@@ -33,6 +35,8 @@ namespace utils {
 const uint64_t kFNVOffsetBasis64 = 0xCBF29CE484222325ull;
 const uint64_t kFNVPrime64 = 1099511628211ull;
 
+const double kMB = 1024.0 * 1024.0;
+
 inline uint64_t FNVHash64(uint64_t val) {
   uint64_t hash = kFNVOffsetBasis64;
 
@@ -95,6 +99,21 @@ inline std::string Trim(const std::string &str) {
       [](int c){ return std::isspace(c); }).base());
 }
 
+///
+/// Total size in bytes of the regular files below path, 0 if it does not exist.
+///
+inline uint64_t DirectorySize(const std::string &path) {
+  namespace fs = std::filesystem;
+  std::error_code ec;
+  uint64_t size = 0;
+  for (fs::recursive_directory_iterator it(path, ec), end; !ec && it != end; it.increment(ec)) {
+    if (it->is_regular_file(ec)) {
+      size += it->file_size(ec);
+    }
+  }
+  return size;
+}
+
 } // utils
 
 } // ycsbc
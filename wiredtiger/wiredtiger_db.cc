@@ -1,6 +1,7 @@
 // Copyright 2023 Chengye YU <yuchengye2013 AT outlook.com>.
 // SPDX-License-Identifier: Apache-2.0
 
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
@@ -15,6 +16,7 @@
 
 #include "core/core_workload.h"
 #include "core/db_factory.h"
+#include "core/scan_profile.h"
 #include "utils/utils.h"
 
 #include "wiredtiger_db.h"
@@ -45,6 +47,21 @@ namespace {
   const std::string PROP_IN_MEMORY = WT_PREFIX ".in_memory";
   const std::string PROP_IN_MEMORY_DEFAULT = "false";
 
+  const std::string PROP_STATISTICS = WT_PREFIX ".statistics";
+  const std::string PROP_STATISTICS_DEFAULT = "";
+
+  // ';' separated prefixes of the statistics descriptions returned by GetMetrics
+  const std::string PROP_METRICS = WT_PREFIX ".metrics";
+  const std::string PROP_METRICS_DEFAULT =
+      "cache: bytes currently in the cache;"
+      "cache: tracked dirty bytes in the cache;"
+      "cache: maximum bytes configured;"
+      "cache: pages evicted by application threads;"
+      "block-manager: bytes read;"
+      "block-manager: bytes written;"
+      "transaction: transaction checkpoint currently running;"
+      "LSM: ";
+
   const std::string PROP_LSM_MGR_MERGE = WT_PREFIX ".lsm_mgr.merge";
   const std::string PROP_LSM_MGR_MERGE_DEFAULT = "true";
 
@@ -102,10 +119,20 @@ void WTDB::Init(){
     method_update_ = &WTDB::UpdateSingleEntry;
     method_insert_ = &WTDB::InsertSingleEntry;
     method_delete_ = &WTDB::DeleteSingleEntry;
+    method_rmw_ = &WTDB::ReadModifyWriteSingleEntry;
   } else {
     throw utils::Exception("single ONLY");
   }
 
+  std::string metrics = props.GetProperty(PROP_METRICS, PROP_METRICS_DEFAULT);
+  for (size_t pos = 0; pos <= metrics.size(); ) {
+    size_t end = std::min(metrics.find(';', pos), metrics.size());
+    if (end > pos) {
+      metric_prefixes_.push_back(metrics.substr(pos, end - pos));
+    }
+    pos = end + 1;
+  }
+
   ref_cnt_++;
   if(conn_){
     error_check(conn_->open_session(conn_, NULL, NULL, &session_));
@@ -131,9 +158,11 @@ void WTDB::Init(){
       const std::string &cache_size = props.GetProperty(PROP_CACHE_SIZE, PROP_CACHE_SIZE_DEFAULT);
       const std::string &direct_io = props.GetProperty(PROP_DIRECT_IO, PROP_DIRECT_IO_DEFAULT);
       const std::string &in_memory = props.GetProperty(PROP_IN_MEMORY, PROP_IN_MEMORY_DEFAULT);
+      const std::string &statistics = props.GetProperty(PROP_STATISTICS, PROP_STATISTICS_DEFAULT);
       if(!cache_size.empty()) db_config += "cache_size="+ cache_size+ ",";
       if(!direct_io.empty())  db_config += "direct_io=" + direct_io + ",";
       if(!in_memory.empty())  db_config += "in_memory=" + in_memory + ",";
+      if(!statistics.empty()) db_config += "statistics=(" + statistics + "),";
     }
     { // 2.2 LSM Manager
       std::string lsm_config;
@@ -195,6 +224,7 @@ void WTDB::Init(){
 }
 
 void WTDB::Cleanup(){
+  ReleaseSnapshot();
   const std::lock_guard<std::mutex> lock(mu_);
   cursor_->close(cursor_);
   error_check(session_->close(session_, NULL));
@@ -204,6 +234,54 @@ void WTDB::Cleanup(){
   error_check(conn_->close(conn_, NULL));
 }
 
+DB::Status WTDB::StartSnapshot(){
+  if (!in_snapshot_) {
+    // reads of this session keep seeing the snapshot until the transaction ends
+    error_check(session_->begin_transaction(session_, "isolation=snapshot"));
+    in_snapshot_ = true;
+  }
+  return kOK;
+}
+
+DB::Status WTDB::ReleaseSnapshot(){
+  if (in_snapshot_) {
+    error_check(session_->rollback_transaction(session_, NULL));
+    in_snapshot_ = false;
+  }
+  return kOK;
+}
+
+DB::Status WTDB::GetMetrics(std::map<std::string, double> *metrics){
+  // the handle is shared with, and closed by, the client threads
+  const std::lock_guard<std::mutex> lock(mu_);
+  if (conn_ == nullptr) {
+    return kError;
+  }
+  // session_ belongs to the client thread, the status thread needs its own
+  WT_SESSION *session;
+  WT_CURSOR *cursor;
+  error_check(conn_->open_session(conn_, NULL, NULL, &session));
+  if (session->open_cursor(session, "statistics:", NULL, NULL, &cursor) != 0) {
+    // statistics=none
+    error_check(session->close(session, NULL));
+    return kNotImplemented;
+  }
+  const char *desc, *pvalue;
+  int64_t value;
+  while (cursor->next(cursor) == 0) {
+    error_check(cursor->get_value(cursor, &desc, &pvalue, &value));
+    for (const std::string &prefix : metric_prefixes_) {
+      if (strncmp(desc, prefix.c_str(), prefix.size()) == 0) {
+        (*metrics)[std::string(WT_PREFIX ".") + desc] = value;
+        break;
+      }
+    }
+  }
+  error_check(cursor->close(cursor));
+  error_check(session->close(session, NULL));
+  return kOK;
+}
+
 DB::Status WTDB::ReadSingleEntry(const std::string &table, const std::string &key,
                                       const std::vector<std::string> *fields,
                                       std::vector<Field> &result) {
@@ -233,11 +311,15 @@ DB::Status WTDB::ScanSingleEntry(const std::string &table, const std::string &ke
   WT_ITEM v;
   int ret = 0, exact;
 
+  // the cursor is reused, there is no iterator to create
+  ScanProfile::Timer timer;
+  timer.Start();
   cursor_->set_key(cursor_, &k);
   error_check(cursor_->search_near(cursor_, &exact));
   if (exact < 0) {
     ret = cursor_->next(cursor_);
   }
+  timer.Stop(ScanProfile::SEEK);
   for(int i=0; !ret && i<len; ++i){
     error_check(cursor_->get_value(cursor_, &v));
     result.emplace_back(std::vector<Field>());
@@ -246,6 +328,9 @@ DB::Status WTDB::ScanSingleEntry(const std::string &table, const std::string &ke
     } else {
       DeserializeRow(&result.back(), (const char*)v.data, v.size);
     }
+    timer.Start();
+    ret = cursor_->next(cursor_);
+    timer.Stop(ScanProfile::NEXT);
   }
   return kOK;
 }
@@ -292,6 +377,66 @@ DB::Status WTDB::UpdateSingleEntry(const std::string &table, const std::string &
   return kOK;
 }
 
+DB::Status WTDB::ReadModifyWriteSingleEntry(const std::string &table, const std::string &key,
+                                            const std::vector<std::string> *fields,
+                                            std::vector<Field> &result,
+                                            std::vector<Field> &values){
+  WT_ITEM k = {key.data(), key.size()};
+  WT_ITEM v;
+  int ret;
+
+  // snapshot transaction, retried as a whole when a concurrent writer wins the conflict
+  for (;;) {
+    std::vector<Field> current_values;
+    std::string data;
+    result.clear();
+    error_check(session_->begin_transaction(session_, "isolation=snapshot"));
+    cursor_->set_key(cursor_, &k);
+    ret = cursor_->search(cursor_);
+    if (ret == 0) {
+      error_check(cursor_->get_value(cursor_, &v));
+      if (fields != nullptr) {
+        DeserializeRowFilter(&result, (const char*)v.data, v.size, *fields);
+      } else {
+        DeserializeRow(&result, (const char*)v.data, v.size);
+      }
+      DeserializeRow(&current_values, (const char*)v.data, v.size);
+      for (Field &new_field : values) {
+        bool found MAYBE_UNUSED = false;
+        for (Field &cur_field : current_values) {
+          if (cur_field.name == new_field.name) {
+            found = true;
+            cur_field.value = new_field.value;
+            break;
+          }
+        }
+        assert(found);
+      }
+      SerializeRow(current_values, &data);
+      v.data = data.data();
+      v.size = data.size();
+      cursor_->set_value(cursor_, &v);
+      ret = cursor_->update(cursor_);
+    }
+    if (ret == 0) {
+      // a failed commit has already been rolled back
+      ret = session_->commit_transaction(session_, NULL);
+      if (ret == 0) {
+        return kOK;
+      } else if (ret != WT_ROLLBACK) {
+        throw utils::Exception(WT_PREFIX " commit error");
+      }
+      continue;
+    }
+    error_check(session_->rollback_transaction(session_, NULL));
+    if (ret == WT_NOTFOUND) {
+      return kNotFound;
+    } else if (ret != WT_ROLLBACK) {
+      throw utils::Exception(WT_PREFIX " read-modify-write error");
+    }
+  }
+}
+
 DB::Status WTDB::InsertSingleEntry(const std::string &table, const std::string &key,
                            std::vector<Field> &values){
   std::string data;
@@ -4,7 +4,9 @@
 #ifndef _WIREDTIGER_DB_H
 #define _WIREDTIGER_DB_H
 
+#include <map>
 #include <string>
+#include <vector>
 #include <mutex>
 
 #include "core/db.h"
@@ -46,6 +48,18 @@ class WTDB : public DB {
     return (this->*(method_delete_))(table, key);
   }
 
+  Status StartSnapshot();
+
+  Status ReleaseSnapshot();
+
+  Status GetMetrics(std::map<std::string, double> *metrics);
+
+  Status ReadModifyWrite(const std::string &table, const std::string &key,
+                         const std::vector<std::string> *fields, std::vector<Field> &result,
+                         std::vector<Field> &values) {
+    return (this->*(method_rmw_))(table, key, fields, result, values);
+  }
+
  private:
 
   Status ReadSingleEntry(const std::string &table, const std::string &key,
@@ -58,6 +72,9 @@ class WTDB : public DB {
   Status InsertSingleEntry(const std::string &table, const std::string &key,
                            std::vector<Field> &values);
   Status DeleteSingleEntry(const std::string &table, const std::string &key);
+  Status ReadModifyWriteSingleEntry(const std::string &table, const std::string &key,
+                                    const std::vector<std::string> *fields,
+                                    std::vector<Field> &result, std::vector<Field> &values);
 
   void SerializeRow(const std::vector<Field> &values, std::string *data);
   void DeserializeRow(std::vector<Field> *values, const char *data_ptr, size_t data_len);
@@ -73,12 +90,17 @@ class WTDB : public DB {
   Status (WTDB::*method_insert_)(const std::string &, const std::string &,
                                       std::vector<Field> &);
   Status (WTDB::*method_delete_)(const std::string &, const std::string &);
+  Status (WTDB::*method_rmw_)(const std::string &, const std::string &,
+                              const std::vector<std::string> *, std::vector<Field> &,
+                              std::vector<Field> &);
   
   unsigned fieldcount_;
 
   static WT_CONNECTION *conn_;
   WT_SESSION *session_{nullptr};
   WT_CURSOR *cursor_{nullptr};
+  bool in_snapshot_{false}; // session_ holds a read transaction
+  std::vector<std::string> metric_prefixes_;
 
   static int ref_cnt_;
   static std::mutex mu_;